@@ -48,6 +48,10 @@
  * - Macro Def Statements     - number of statements defined in macro files (only the first occurence of the macro)
  * - Lookahead Statements     - number of statements processed in lookahead mode
  * - Reparsed Statements      - number of statements that were reparsed later (e.g. model statements)
+ * - Reparse Cache Hits       - number of reparsed statements whose operands were taken from the cache of previous parses
+ * - Reparse Cache Hit Rate   - ratio of the reparse cache hits to all reparsed statements
+ * - SLL Parses               - number of operand fields parsed with the faster SLL prediction first
+ * - LL Fallbacks             - number of SLL parses that failed and were repeated with full LL prediction
  * - Continued Statements     - number of statements that were continued (multiple continuations of one statement count
  *as one continued statement)
  * - Non-continued Statements - number of statements that were not continued
@@ -55,6 +59,9 @@
  * - ExecStatement/ms         - ExecStatements includes open code, macro, copy, lookahead and reparsed statements
  * - Line/ms
  * - Files                    - total number of parsed files
+ * - Proc Grp Cache Hits      - number of processor group lookups served from the cache
+ * - Lexed Tokens             - number of tokens created by the lexers of the analysis
+ * - Token Allocations        - number of heap allocations of the token storage (tokens are allocated in blocks and reused)
  */
 
 using json = nlohmann::json;
@@ -156,6 +163,9 @@ json parse_one_file(const std::string& source_file,
     auto exec_statements = collector.metrics_.open_code_statements + collector.metrics_.copy_statements
         + collector.metrics_.macro_statements + collector.metrics_.lookahead_statements
         + collector.metrics_.reparsed_statements;
+    auto reparse_hit_rate = collector.metrics_.reparsed_statements
+        ? collector.metrics_.reparse_cache_hits / (double)collector.metrics_.reparsed_statements
+        : 0.0;
     s.average_stmt_ms += (exec_statements / (double)time);
     s.average_line_ms += collector.metrics_.lines / (double)time;
     s.all_files += collector.metrics_.files;
@@ -171,12 +181,19 @@ json parse_one_file(const std::string& source_file,
                   << "Macro Def Statements: " << collector.metrics_.macro_def_statements << '\n'
                   << "Lookahead Statements: " << collector.metrics_.lookahead_statements << '\n'
                   << "Reparsed Statements: " << collector.metrics_.reparsed_statements << '\n'
+                  << "Reparse Cache Hits: " << collector.metrics_.reparse_cache_hits << '\n'
+                  << "Reparse Cache Hit Rate: " << reparse_hit_rate << '\n'
+                  << "SLL Parses: " << collector.metrics_.sll_parses << '\n'
+                  << "LL Fallbacks: " << collector.metrics_.ll_fallbacks << '\n'
                   << "Continued Statements: " << collector.metrics_.continued_statements << '\n'
                   << "Non-continued Statements: " << collector.metrics_.non_continued_statements << '\n'
                   << "Lines: " << collector.metrics_.lines << '\n'
                   << "Executed Statement/ms: " << exec_statements / (double)time << '\n'
                   << "Line/ms: " << collector.metrics_.lines / (double)time << '\n'
-                  << "Files: " << collector.metrics_.files << "\n\n"
+                  << "Files: " << collector.metrics_.files << '\n'
+                  << "Proc Grp Cache Hits: " << collector.metrics_.proc_grp_cache_hits << '\n'
+                  << "Lexed Tokens: " << collector.metrics_.lexed_tokens << '\n'
+                  << "Token Allocations: " << collector.metrics_.token_allocations << "\n\n"
                   << std::endl;
 
     return json({ { "File", source_file },
@@ -192,13 +209,20 @@ json parse_one_file(const std::string& source_file,
         { "Macro Def Statements", collector.metrics_.macro_def_statements },
         { "Lookahead Statements", collector.metrics_.lookahead_statements },
         { "Reparsed Statements", collector.metrics_.reparsed_statements },
+        { "Reparse Cache Hits", collector.metrics_.reparse_cache_hits },
+        { "Reparse Cache Hit Rate", reparse_hit_rate },
+        { "SLL Parses", collector.metrics_.sll_parses },
+        { "LL Fallbacks", collector.metrics_.ll_fallbacks },
         { "Continued Statements", collector.metrics_.continued_statements },
         { "Non-continued Statements", collector.metrics_.non_continued_statements },
         { "Executed Statements", exec_statements },
         { "Lines", collector.metrics_.lines },
         { "ExecStatement/ms", exec_statements / (double)time },
         { "Line/ms", collector.metrics_.lines / (double)time },
-        { "Files", collector.metrics_.files } });
+        { "Files", collector.metrics_.files },
+        { "Proc Grp Cache Hits", collector.metrics_.proc_grp_cache_hits },
+        { "Lexed Tokens", collector.metrics_.lexed_tokens },
+        { "Token Allocations", collector.metrics_.token_allocations } });
 }
 
 std::string get_file_message(size_t iter, size_t begin, size_t end, const std::string& base_message)
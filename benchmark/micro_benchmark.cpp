@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "analyzer.h"
+#include "context/hlasm_context.h"
+#include "context/id_storage.h"
+#include "context/variables/set_symbol.h"
+#include "expressions/conditional_assembly/ca_bytecode.h"
+#include "expressions/conditional_assembly/ca_operator_binary.h"
+#include "expressions/conditional_assembly/ca_operator_unary.h"
+#include "expressions/conditional_assembly/terms/ca_constant.h"
+#include "expressions/conditional_assembly/terms/ca_var_sym.h"
+#include "expressions/evaluation_context.h"
+
+/*
+ * The micro benchmark measures isolated parts of the parse library that are hot during the analysis.
+ * Each case is run the given number of iterations and the average time of one iteration is printed.
+ *
+ * Accepted parameters:
+ *  -n - number of iterations of each case (default 1000000)
+ * Cases:
+ * - id_storage add       - insertion of an identifier that is already present
+ * - id_storage find      - lookup of a present identifier written in lower case
+ * - id_storage find miss - lookup of an identifier that is not present
+ * - id_storage find long - lookup of a present identifier that does not fit into short string buffer
+ * - hlasm_context create - construction of a context for a new analysis
+ * - set_symbol write     - assignment to an element of a SETC array filled in a loop
+ * - set_symbol read      - read of an element of a SETC array
+ * - set_symbol N'        - N' attribute of a SETC array
+ * - CA array loop        - analysis of a macro filling and reading a SETC array of 1000 elements in a loop
+ * - macro call loop      - analysis of a macro invoking another macro 1000 times in a loop
+ * - ca_expression tree   - tree-walking evaluation of a logical expression with arithmetic operands
+ * - ca_bytecode          - evaluation of the same expression compiled into a stack program
+ */
+
+using namespace hlasm_plugin::parser_library;
+
+namespace {
+
+// prevents the compiler from optimizing the measured computation away
+volatile size_t sink;
+
+void measure(const std::string& name, size_t iterations, const std::function<size_t(size_t)>& iteration)
+{
+    size_t result = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        result += iteration(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    sink = result;
+
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::clog << name << ": " << time / (double)iterations << " ns" << std::endl;
+}
+
+std::vector<std::string> make_identifiers(size_t count, const std::string& prefix)
+{
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < count; ++i)
+        ids.push_back(prefix + std::to_string(i));
+    return ids;
+}
+
+void id_storage_cases(size_t iterations)
+{
+    context::id_storage storage;
+    auto ids = make_identifiers(1000, "SYMBOL");
+    auto lower_ids = make_identifiers(1000, "symbol");
+    auto missing_ids = make_identifiers(1000, "missing");
+    auto long_ids = make_identifiers(1000, "long_symbol_name_");
+    for (const auto& id : ids)
+        storage.add(id);
+    for (const auto& id : long_ids)
+        storage.add(id);
+
+    measure("id_storage add", iterations, [&](size_t i) { return (size_t)storage.add(ids[i % ids.size()]); });
+    measure("id_storage find", iterations, [&](size_t i) {
+        return (size_t)storage.find(lower_ids[i % lower_ids.size()]);
+    });
+    measure("id_storage find miss", iterations, [&](size_t i) {
+        return (size_t)storage.find(missing_ids[i % missing_ids.size()]);
+    });
+    measure("id_storage find long", iterations, [&](size_t i) {
+        return (size_t)storage.find(long_ids[i % long_ids.size()]);
+    });
+}
+
+void hlasm_context_cases(size_t iterations)
+{
+    // the construction is much more expensive than the cases above
+    iterations = std::max<size_t>(iterations / 1000, 1);
+    auto ids = std::make_shared<context::id_storage>();
+    measure("hlasm_context create", iterations, [&](size_t) {
+        context::hlasm_context ctx("file", ids);
+        return (size_t)ctx.ids().well_known.empty;
+    });
+}
+
+void set_symbol_cases(size_t iterations)
+{
+    constexpr size_t array_size = 1000;
+    context::id_storage storage;
+    context::set_symbol<context::C_t> arr(storage.add("ARR"), false, false);
+    for (size_t i = 0; i < array_size; ++i)
+        arr.set_value("VALUE", i);
+
+    measure("set_symbol write", iterations, [&](size_t i) {
+        arr.set_value("VALUE", i % array_size);
+        return (size_t)1;
+    });
+    measure("set_symbol read", iterations, [&](size_t i) { return arr.get_value(i % array_size).size(); });
+    measure("set_symbol N'", iterations, [&](size_t) { return (size_t)arr.number({}); });
+}
+
+void ca_loop_cases(size_t iterations)
+{
+    // the analysis is much more expensive than the cases above
+    iterations = std::max<size_t>(iterations / 100000, 1);
+    const std::string source = R"(
+         MACRO
+         FILL  &N
+         LCLC  &ARR(1)
+         LCLA  &I,&LEN
+         ACTR  10000
+&I       SETA  1
+.FILL    AIF   (&I GT &N).READ
+&ARR(&I) SETC  'E&I'
+&I       SETA  &I+1
+         AGO   .FILL
+.READ    ANOP
+&I       SETA  N'&ARR
+.LOOP    AIF   (&I LT 1).END
+&LEN     SETA  &LEN+K'&ARR(&I)
+&I       SETA  &I-1
+         AGO   .LOOP
+.END     MEND
+
+         FILL  1000
+)";
+    measure("CA array loop", iterations, [&](size_t) {
+        analyzer a(source);
+        a.analyze();
+        return (size_t)a.context().macros().size();
+    });
+
+    const std::string call_source = R"(
+         MACRO
+         INNER
+         GBLA  &COUNT
+&COUNT   SETA  &COUNT+1
+         MEND
+
+         MACRO
+         OUTER &N
+         LCLA  &I
+         ACTR  10000
+.LOOP    AIF   (&I GE &N).END
+&I       SETA  &I+1
+         INNER
+         AGO   .LOOP
+.END     MEND
+
+         OUTER 1000
+)";
+    measure("macro call loop", iterations, [&](size_t) {
+        analyzer a(call_source);
+        a.analyze();
+        return (size_t)a.context().macros().size();
+    });
+}
+
+void ca_expression_cases(size_t iterations)
+{
+    using namespace expressions;
+    context::hlasm_context ctx;
+    evaluation_context eval_ctx { ctx, workspaces::empty_parse_lib_provider::instance };
+
+    auto name = ctx.ids().add("V");
+    auto var = ctx.create_local_variable<context::A_t>(name, true)->access_set_symbol<context::A_t>();
+    auto constant = [](context::A_t value) { return std::make_unique<ca_constant>(value, range()); };
+    auto var_sym = [&]() {
+        return std::make_unique<ca_var_sym>(
+            std::make_unique<semantics::basic_variable_symbol>(name, std::vector<ca_expr_ptr> {}, range()), range());
+    };
+
+    // ((&V+1)*3-&V/2 GT 10) AND NOT (&V EQ 0)
+    auto arith = std::make_unique<ca_basic_binary_operator<ca_sub>>(
+        std::make_unique<ca_basic_binary_operator<ca_mul>>(
+            std::make_unique<ca_par_operator>(
+                std::make_unique<ca_basic_binary_operator<ca_add>>(var_sym(), constant(1), range()), range()),
+            constant(3),
+            range()),
+        std::make_unique<ca_basic_binary_operator<ca_div>>(var_sym(), constant(2), range()),
+        range());
+    arith->expr_kind = context::SET_t_enum::A_TYPE;
+    auto equal = var_sym();
+    equal->expr_kind = context::SET_t_enum::A_TYPE;
+    ca_expr_ptr expr = std::make_unique<ca_function_binary_operator>(
+        std::make_unique<ca_function_binary_operator>(
+            std::move(arith), constant(10), ca_expr_ops::GT, context::SET_t_enum::B_TYPE, range()),
+        std::make_unique<ca_function_unary_operator>(
+            std::make_unique<ca_function_binary_operator>(
+                std::move(equal), constant(0), ca_expr_ops::EQ, context::SET_t_enum::B_TYPE, range()),
+            ca_expr_ops::NOT,
+            context::SET_t_enum::B_TYPE,
+            range()),
+        ca_expr_ops::AND,
+        context::SET_t_enum::B_TYPE,
+        range());
+    auto bytecode = ca_bytecode::compile(*expr);
+
+    measure("ca_expression tree", iterations, [&](size_t i) {
+        var->set_value((context::A_t)(i % 100));
+        return (size_t)expr->evaluate<context::B_t>(eval_ctx);
+    });
+    measure("ca_bytecode", iterations, [&](size_t i) {
+        var->set_value((context::A_t)(i % 100));
+        return (size_t)bytecode->evaluate<context::B_t>(eval_ctx);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t iterations = 1000000;
+    for (int i = 1; i < argc - 1; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-n")
+        {
+            try
+            {
+                iterations = std::stoul(argv[i + 1]);
+            }
+            catch (...)
+            {
+                std::clog << "Number of iterations must be an integer" << '\n';
+                return 1;
+            }
+            i++;
+        }
+    }
+
+    id_storage_cases(iterations);
+    hlasm_context_cases(iterations);
+    set_symbol_cases(iterations);
+    ca_loop_cases(iterations);
+    ca_expression_cases(iterations);
+
+    return 0;
+}
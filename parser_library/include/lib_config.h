@@ -34,6 +34,13 @@ public:
     [[nodiscard]] lib_config fill_missing_settings(const lib_config& second);
 
     std::optional<int64_t> diag_supress_limit;
+    // number of threads that re-analyze dependant programs after a change of the workspace configuration
+    std::optional<int64_t> parallel_analysis_workers;
+    // whether parsed macro definitions are stored in the workspace, so they are not parsed again after a restart
+    std::optional<bool> persistent_macro_cache;
+    // whether operands of conditional assembly statements in library macros are parsed only when executed,
+    // syntax errors in statements that are never executed are not reported then
+    std::optional<bool> defer_macro_ca_operands;
 
 
 
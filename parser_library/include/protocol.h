@@ -241,10 +241,16 @@ struct PARSER_LIBRARY_EXPORT performance_metrics
     size_t copy_def_statements = 0;
     size_t copy_statements = 0;
     size_t reparsed_statements = 0;
+    size_t reparse_cache_hits = 0;
+    size_t sll_parses = 0;
+    size_t ll_fallbacks = 0;
     size_t lookahead_statements = 0;
     size_t continued_statements = 0;
     size_t non_continued_statements = 0;
     size_t files = 0;
+    size_t proc_grp_cache_hits = 0;
+    size_t lexed_tokens = 0;
+    size_t token_allocations = 0;
 };
 
 struct PARSER_LIBRARY_EXPORT diagnostic_list
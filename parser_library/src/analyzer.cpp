@@ -22,7 +22,7 @@ using namespace hlasm_plugin::parser_library::lexing;
 using namespace hlasm_plugin::parser_library::parsing;
 using namespace hlasm_plugin::parser_library::workspaces;
 
-analyzer::analyzer(const std::string& text,
+analyzer::analyzer(std::string_view text,
     std::string file_name,
     parse_lib_provider& lib_provider,
     context::hlasm_context* hlasm_ctx,
@@ -35,7 +35,7 @@ analyzer::analyzer(const std::string& text,
     , hlasm_ctx_ref_(*hlasm_ctx)
     , listener_(file_name)
     , lsp_proc_(file_name, text, hlasm_ctx, collect_hl_info)
-    , input_(text)
+    , input_(text, lexing::input_source::non_owning)
     , lexer_(&input_, &lsp_proc_, &hlasm_ctx_ref_.metrics)
     , tokens_(&lexer_)
     , parser_(new parsing::hlasmparser(&tokens_))
@@ -51,9 +51,11 @@ analyzer::analyzer(const std::string& text,
     parser_->setErrorHandler(std::make_shared<error_strategy>());
     parser_->removeErrorListeners();
     parser_->addErrorListener(&listener_);
+
+    tokens_.enable_windowing();
 }
 
-analyzer::analyzer(const std::string& text,
+analyzer::analyzer(std::string_view text,
     std::string file_name,
     context::hlasm_context& hlasm_ctx,
     parse_lib_provider& lib_provider,
@@ -62,7 +64,7 @@ analyzer::analyzer(const std::string& text,
     : analyzer(text, file_name, lib_provider, &hlasm_ctx, data, false, nullptr, collect_hl_info)
 {}
 
-analyzer::analyzer(const std::string& text,
+analyzer::analyzer(std::string_view text,
     std::string file_name,
     parse_lib_provider& lib_provider,
     processing::processing_tracer* tracer,
@@ -70,7 +72,7 @@ analyzer::analyzer(const std::string& text,
     : analyzer(text,
         file_name,
         lib_provider,
-        new context::hlasm_context(file_name),
+        new context::hlasm_context(file_name, lib_provider.get_id_storage()),
         library_data { processing::processing_kind::ORDINARY, context::id_storage::empty_id },
         true,
         tracer,
@@ -44,14 +44,15 @@ class analyzer : public diagnosable_ctx
     processing::processing_manager mngr_;
 
 public:
-    analyzer(const std::string& text,
+    // the text is not copied, it must outlive the analyzer
+    analyzer(std::string_view text,
         std::string file_name,
         context::hlasm_context& hlasm_ctx,
         workspaces::parse_lib_provider& lib_provider,
         const workspaces::library_data data,
         bool collect_hl_info = false);
 
-    analyzer(const std::string& text,
+    analyzer(std::string_view text,
         std::string file_name = "",
         workspaces::parse_lib_provider& lib_provider = workspaces::empty_parse_lib_provider::instance,
         processing::processing_tracer* tracer = nullptr,
@@ -67,7 +68,7 @@ public:
     const performance_metrics& get_metrics();
 
 private:
-    analyzer(const std::string& text,
+    analyzer(std::string_view text,
         std::string file_name,
         workspaces::parse_lib_provider& lib_provider,
         context::hlasm_context* hlasm_ctx,
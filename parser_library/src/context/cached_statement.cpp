@@ -23,25 +23,91 @@ cached_statement_storage::cached_statement_storage(shared_stmt_ptr base)
     : base_stmt_(std::move(base))
 {}
 
+cached_statement_storage::cached_statement_storage(const cached_statement_storage& other)
+    : base_stmt_(other.base_stmt_)
+{
+    std::lock_guard guard(other.mutex_);
+    cache_ = other.cache_;
+    resolved_stmt_ = other.resolved_stmt_;
+    resolved_generation_ = other.resolved_generation_;
+}
+
+cached_statement_storage::cached_statement_storage(cached_statement_storage&& other) noexcept
+    : cache_(std::move(other.cache_))
+    , base_stmt_(std::move(other.base_stmt_))
+    , resolved_stmt_(std::move(other.resolved_stmt_))
+    , resolved_generation_(other.resolved_generation_)
+{}
+
+cached_statement_storage& cached_statement_storage::operator=(const cached_statement_storage& other)
+{
+    if (this == &other)
+        return *this;
+    std::scoped_lock guard(mutex_, other.mutex_);
+    cache_ = other.cache_;
+    base_stmt_ = other.base_stmt_;
+    resolved_stmt_ = other.resolved_stmt_;
+    resolved_generation_ = other.resolved_generation_;
+    return *this;
+}
+
+cached_statement_storage& cached_statement_storage::operator=(cached_statement_storage&& other) noexcept
+{
+    cache_ = std::move(other.cache_);
+    base_stmt_ = std::move(other.base_stmt_);
+    resolved_stmt_ = std::move(other.resolved_stmt_);
+    resolved_generation_ = other.resolved_generation_;
+    return *this;
+}
+
 bool cached_statement_storage::contains(processing::processing_form format) const
 {
+    std::lock_guard guard(mutex_);
     for (const auto& entry : cache_)
-        if (entry.first == format)
+        if (entry.form == format)
             return true;
     return false;
 }
 
-void cached_statement_storage::insert(processing::processing_form format, cache_entry_t statement)
+void cached_statement_storage::insert(
+    processing::processing_form format, cache_entry_t statement, deferred_effects_ptr effects)
 {
-    cache_.emplace_back(format, std::move(statement));
+    std::lock_guard guard(mutex_);
+    for (const auto& entry : cache_)
+        if (entry.form == format)
+            return;
+    cache_.push_back({ format, std::move(statement), std::move(effects) });
 }
 
 cached_statement_storage::cache_entry_t cached_statement_storage::get(processing::processing_form format) const
 {
+    std::lock_guard guard(mutex_);
     for (const auto& entry : cache_)
-        if (entry.first == format)
-            return entry.second;
+        if (entry.form == format)
+            return entry.statement;
     return nullptr;
 }
 
+deferred_effects_ptr cached_statement_storage::get_effects(processing::processing_form format) const
+{
+    std::lock_guard guard(mutex_);
+    for (const auto& entry : cache_)
+        if (entry.form == format)
+            return entry.effects;
+    return nullptr;
+}
+
+shared_stmt_ptr cached_statement_storage::get_resolved(std::uint64_t generation) const
+{
+    std::lock_guard guard(mutex_);
+    return resolved_generation_ == generation ? resolved_stmt_ : nullptr;
+}
+
+void cached_statement_storage::set_resolved(std::uint64_t generation, shared_stmt_ptr statement)
+{
+    std::lock_guard guard(mutex_);
+    resolved_stmt_ = std::move(statement);
+    resolved_generation_ = generation;
+}
+
 shared_stmt_ptr cached_statement_storage::get_base() const { return base_stmt_; }
@@ -15,7 +15,13 @@
 #ifndef CONTEXT_PROCESSING_CACHED_STATEMENT_H
 #define CONTEXT_PROCESSING_CACHED_STATEMENT_H
 
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "diagnostic.h"
 #include "hlasm_statement.h"
+#include "lsp_context.h"
 #include "processing/processing_format.h"
 
 namespace hlasm_plugin {
@@ -25,30 +31,68 @@ struct statement_si_defer_done;
 }
 namespace context {
 
+// side effects of the parse of a deferred statement
+// the parsed statement is shared by all the analyses that use the definition, so each of them reports the effects
+struct deferred_parse_effects
+{
+    // diagnostics reported by the error listener, they get the processing stack when they are reported
+    std::vector<diagnostic_op> listener_diags;
+    // diagnostics reported by the parser itself
+    std::vector<diagnostic_s> parser_diags;
+    // LSP symbols found in the parsed fields
+    std::vector<lsp_symbol> lsp_symbols;
+};
+
+using deferred_effects_ptr = std::shared_ptr<const deferred_parse_effects>;
+
 // storage used to store one deferred statement in many parsed formats
 // used by macro and copy definition to avoid multiple re-parsing of a deferrend stataments
+// definitions can be shared by analyses running in parallel, hence the access to the cache is synchronized
 class cached_statement_storage
 {
 public:
     // reparsed statement type
     using cache_entry_t = std::shared_ptr<semantics::statement_si_defer_done>;
-    // pair of processing format and reparsed statement
+    // reparsed statement together with the side effects of its parse
     // processing format serves as an identifier of reparsing kind
-    using cached_statement_t = std::pair<processing::processing_form, cache_entry_t>;
+    struct cached_statement_t
+    {
+        processing::processing_form form;
+        cache_entry_t statement;
+        deferred_effects_ptr effects;
+    };
 
 private:
     std::vector<cached_statement_t> cache_;
     shared_stmt_ptr base_stmt_;
+    // statement resolved for the ordinary processing and the operation code generation it was resolved in
+    shared_stmt_ptr resolved_stmt_;
+    std::uint64_t resolved_generation_ = 0;
+    mutable std::mutex mutex_;
 
 public:
     cached_statement_storage(shared_stmt_ptr base);
+    cached_statement_storage(const cached_statement_storage& other);
+    cached_statement_storage(cached_statement_storage&& other) noexcept;
+    cached_statement_storage& operator=(const cached_statement_storage& other);
+    cached_statement_storage& operator=(cached_statement_storage&& other) noexcept;
 
     bool contains(processing::processing_form format) const;
 
-    void insert(processing::processing_form format, cache_entry_t statement);
+    // the statement is not inserted if the format is already present
+    void insert(processing::processing_form format, cache_entry_t statement, deferred_effects_ptr effects);
 
     cache_entry_t get(processing::processing_form format) const;
 
+    // effects of the parse of the statement in the format, nullptr when the parse had none
+    deferred_effects_ptr get_effects(processing::processing_form format) const;
+
+    // gets the resolved statement, returns nullptr when it was resolved in a different operation code generation
+    shared_stmt_ptr get_resolved(std::uint64_t generation) const;
+
+    // stores the statement resolved in the operation code generation, replaces the previous one
+    void set_resolved(std::uint64_t generation, shared_stmt_ptr statement);
+
     shared_stmt_ptr get_base() const;
 };
 
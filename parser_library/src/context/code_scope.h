@@ -45,19 +45,98 @@ struct code_scope
 
     bool is_in_macro() const { return !!this_macro; }
 
-    code_scope(macro_invo_ptr macro_invo, macro_def_ptr macro_def)
+    // the frame is a reused vector, it is filled with the params of the macro invocation
+    code_scope(macro_invo_ptr macro_invo, macro_def_ptr macro_def, std::vector<var_sym_ptr> frame)
         : this_macro(std::move(macro_invo))
         , branch_counter(4096)
         , branch_counter_change(0)
         , this_macro_def_(std::move(macro_def))
-    {}
+        , frame_(std::move(frame))
+    {
+        frame_.assign(this_macro_def_->frame_size(), nullptr);
+        for (const auto& param : this_macro->params)
+        {
+            auto slot = this_macro_def_->variable_slot(param->id);
+            if (slot != macro_definition::no_slot && !frame_[slot])
+                frame_[slot] = param;
+        }
+    }
     code_scope()
         : branch_counter(4096)
         , branch_counter_change(0)
     {}
 
+    // returns the variable symbol visible in the scope, nullptr when there is none
+    variable_symbol* find_variable(id_index name) const
+    {
+        if (auto slot = frame_slot(name); slot != macro_definition::no_slot)
+            return frame_[slot].get();
+
+        if (auto it = variables.find(name); it != variables.end())
+            return it->second.get();
+        if (auto it = system_variables.find(name); it != system_variables.end())
+            return it->second.get();
+        if (is_in_macro())
+            return this_macro->find_param(name);
+        return nullptr;
+    }
+
+    // returns the set symbol of the scope, nullptr when there is none
+    set_sym_ptr find_set_symbol(id_index name) const
+    {
+        if (auto slot = frame_slot(name); slot != macro_definition::no_slot)
+        {
+            if (frame_[slot] && frame_[slot]->access_set_symbol_base())
+                return std::static_pointer_cast<set_symbol_base>(frame_[slot]);
+            return nullptr;
+        }
+
+        auto it = variables.find(name);
+        return it == variables.end() ? nullptr : it->second;
+    }
+
+    // adds the set symbol to the scope, it hides a macro param with the same name
+    void add_set_symbol(set_sym_ptr var)
+    {
+        if (auto slot = frame_slot(var->id); slot != macro_definition::no_slot)
+        {
+            if (!frame_[slot] || !frame_[slot]->access_set_symbol_base())
+                frame_[slot] = std::move(var);
+        }
+        else
+            variables.try_emplace(var->id, std::move(var));
+    }
+
+    // adds the system variable to the scope, it hides a macro param with the same name
+    void add_system_variable(sys_sym_ptr var)
+    {
+        if (auto slot = frame_slot(var->id); slot != macro_definition::no_slot)
+        {
+            if (!frame_[slot] || frame_[slot]->access_macro_param_base())
+                frame_[slot] = std::move(var);
+        }
+        else
+            system_variables.try_emplace(var->id, std::move(var));
+    }
+
+    // local variables kept in the slots of the frame
+    const std::vector<var_sym_ptr>& frame() const { return frame_; }
+    // takes the frame away from the scope, so that it can be reused
+    std::vector<var_sym_ptr> release_frame()
+    {
+        frame_.clear();
+        return std::move(frame_);
+    }
+
 private:
     macro_def_ptr this_macro_def_;
+    // variables of the macro invocation in the slots given by the macro definition
+    std::vector<var_sym_ptr> frame_;
+
+    size_t frame_slot(id_index name) const
+    {
+        return this_macro_def_ ? this_macro_def_->variable_slot(name) : macro_definition::no_slot;
+    }
 };
 
 } // namespace context
@@ -15,6 +15,8 @@
 #ifndef CONTEXT_COPY_MEMBER_H
 #define CONTEXT_COPY_MEMBER_H
 
+#include <memory>
+
 #include "cached_statement.h"
 #include "id_storage.h"
 #include "range.h"
@@ -60,6 +62,8 @@ struct copy_member
     copy_member_invocation enter() { return copy_member_invocation(name, cached_definition, definition_location); }
 };
 
+using copy_member_ptr = std::shared_ptr<copy_member>;
+
 } // namespace context
 } // namespace parser_library
 } // namespace hlasm_plugin
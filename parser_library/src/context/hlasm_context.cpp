@@ -14,6 +14,8 @@
 
 #include "hlasm_context.h"
 
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <stdexcept>
 
@@ -24,33 +26,30 @@
 
 namespace hlasm_plugin::parser_library::context {
 
+namespace {
+// source of the operation code generations of all contexts
+std::atomic<std::uint64_t> opcode_generation_source = 0;
+} // namespace
+
 code_scope* hlasm_context::curr_scope() { return &scope_stack_.back(); }
 
 const code_scope* hlasm_context::curr_scope() const { return &scope_stack_.back(); }
 
-hlasm_context::instruction_storage hlasm_context::init_instruction_map()
-{
-    hlasm_context::instruction_storage instr_map;
-    for (auto& [name, instr] : instruction::machine_instructions)
-    {
-        auto id = ids_.add(name);
-        instr_map.emplace(id, instruction::instruction_array::MACH);
-    }
-    for (auto& [name, instr] : instruction::assembler_instructions)
-    {
-        auto id = ids_.add(name);
-        instr_map.emplace(id, instruction::instruction_array::ASM);
-    }
-    for (auto& instr : instruction::ca_instructions)
-    {
-        auto id = ids_.add(instr.name);
-        instr_map.emplace(id, instruction::instruction_array::CA);
-    }
-    for (auto& [name, instr] : instruction::mnemonic_codes)
-    {
-        auto id = ids_.add(name);
-        instr_map.emplace(id, instruction::instruction_array::MNEM);
-    }
+const hlasm_context::instruction_storage& hlasm_context::get_instruction_map()
+{
+    // the instructions are the same for all contexts, the map is built once and then only read
+    static const instruction_storage instr_map = []() {
+        instruction_storage map;
+        for (auto& [name, instr] : instruction::machine_instructions)
+            map.emplace(name, instruction::instruction_array::MACH);
+        for (auto& [name, instr] : instruction::assembler_instructions)
+            map.emplace(name, instruction::instruction_array::ASM);
+        for (auto& instr : instruction::ca_instructions)
+            map.emplace(instr.name, instruction::instruction_array::CA);
+        for (auto& [name, instr] : instruction::mnemonic_codes)
+            map.emplace(name, instruction::instruction_array::MNEM);
+        return map;
+    }();
     return instr_map;
 }
 
@@ -64,7 +63,7 @@ void hlasm_context::add_system_vars_to_scope()
             auto val_sect = std::make_shared<set_symbol<C_t>>(SYSECT, true, false);
             auto sect_name = ord_ctx.current_section() ? ord_ctx.current_section()->name : id_storage::empty_id;
             val_sect->set_value(*sect_name);
-            curr_scope()->variables.insert({ SYSECT, val_sect });
+            curr_scope()->add_set_symbol(val_sect);
         }
 
         {
@@ -78,7 +77,7 @@ void hlasm_context::add_system_vars_to_scope()
                 value.insert(value.begin(), '0');
 
             val_ndx->set_value(std::move(value));
-            curr_scope()->variables.insert({ SYSNDX, val_ndx });
+            curr_scope()->add_set_symbol(val_ndx);
         }
 
         {
@@ -105,7 +104,7 @@ void hlasm_context::add_system_vars_to_scope()
                         break;
                 }
             }
-            curr_scope()->variables.insert({ SYSSTYP, val_styp });
+            curr_scope()->add_set_symbol(val_styp);
         }
 
         {
@@ -117,7 +116,7 @@ void hlasm_context::add_system_vars_to_scope()
             {
                 var->set_value(*ord_ctx.current_section()->current_location_counter().name);
             }
-            curr_scope()->variables.insert({ SYSLOC, var });
+            curr_scope()->add_set_symbol(var);
         }
 
         {
@@ -127,7 +126,7 @@ void hlasm_context::add_system_vars_to_scope()
 
             var->set_value((context::A_t)scope_stack_.size() - 1);
 
-            curr_scope()->variables.insert({ SYSNEST, var });
+            curr_scope()->add_set_symbol(var);
         }
 
         {
@@ -149,7 +148,7 @@ void hlasm_context::add_system_vars_to_scope()
 
             auto var = std::make_shared<system_variable>(SYSMAC, std::move(mac_data), false);
 
-            curr_scope()->system_variables.insert({ SYSMAC, var });
+            curr_scope()->add_system_variable(var);
         }
     }
     add_global_system_vars();
@@ -232,28 +231,29 @@ void hlasm_context::add_global_system_vars()
     }
 
     auto glob = globals_.find(SYSDATC);
-    curr_scope()->variables.insert({ glob->second->id, glob->second });
+    curr_scope()->add_set_symbol(glob->second);
     glob = globals_.find(SYSDATE);
-    curr_scope()->variables.insert({ glob->second->id, glob->second });
+    curr_scope()->add_set_symbol(glob->second);
     glob = globals_.find(SYSTIME);
-    curr_scope()->variables.insert({ glob->second->id, glob->second });
+    curr_scope()->add_set_symbol(glob->second);
     glob = globals_.find(SYSPARM);
-    curr_scope()->variables.insert({ glob->second->id, glob->second });
+    curr_scope()->add_set_symbol(glob->second);
     glob = globals_.find(SYSOPT_RENT);
-    curr_scope()->variables.insert({ glob->second->id, glob->second });
+    curr_scope()->add_set_symbol(glob->second);
 }
 
 bool hlasm_context::is_opcode(id_index symbol) const
 {
-    return macros_.find(symbol) != macros_.end() || instruction_map_.find(symbol) != instruction_map_.end();
+    return macros_.find(symbol) != macros_.end() || get_instruction_map().find(*symbol) != get_instruction_map().end();
 }
 
-hlasm_context::hlasm_context(std::string file_name)
-    : instruction_map_(init_instruction_map())
+hlasm_context::hlasm_context(std::string file_name, std::shared_ptr<id_storage> init_ids)
+    : ids_(init_ids ? std::move(init_ids) : std::make_shared<id_storage>())
     , SYSNDX_(0)
-    , ord_ctx(ids_)
+    , ord_ctx(*ids_)
     , lsp_ctx(std::make_shared<lsp_context>())
 {
+    next_opcode_generation();
     scope_stack_.emplace_back();
     visited_files_.insert(file_name);
     push_statement_processing(processing::processing_kind::ORDINARY, std::move(file_name));
@@ -329,9 +329,11 @@ void hlasm_context::pop_statement_processing()
     proc_stack_.pop_back();
 }
 
-id_storage& hlasm_context::ids() { return ids_; }
+id_storage& hlasm_context::ids() { return *ids_; }
+
+std::shared_ptr<id_storage> hlasm_context::ids_ptr() { return ids_; }
 
-const hlasm_context::instruction_storage& hlasm_context::instruction_map() const { return instruction_map_; }
+const hlasm_context::instruction_storage& hlasm_context::instruction_map() const { return get_instruction_map(); }
 
 processing_stack_t hlasm_context::processing_stack() const
 {
@@ -395,25 +397,7 @@ void hlasm_context::fill_metrics_files()
 
 const code_scope::set_sym_storage& hlasm_context::globals() const { return globals_; }
 
-var_sym_ptr hlasm_context::get_var_sym(id_index name)
-{
-    auto tmp = curr_scope()->variables.find(name);
-    if (tmp != curr_scope()->variables.end())
-        return tmp->second;
-
-    auto s_tmp = curr_scope()->system_variables.find(name);
-    if (s_tmp != curr_scope()->system_variables.end())
-        return s_tmp->second;
-
-    if (curr_scope()->is_in_macro())
-    {
-        auto m_tmp = curr_scope()->this_macro->named_params.find(name);
-        if (m_tmp != curr_scope()->this_macro->named_params.end())
-            return m_tmp->second;
-    }
-
-    return var_sym_ptr();
-}
+variable_symbol* hlasm_context::get_var_sym(id_index name) { return curr_scope()->find_variable(name); }
 
 void hlasm_context::add_sequence_symbol(sequence_symbol_ptr seq_sym)
 {
@@ -469,14 +453,15 @@ void hlasm_context::add_mnemonic(id_index mnemo, id_index op_code)
             throw std::invalid_argument("undefined operation code");
 
         opcode_mnemo_.insert_or_assign(mnemo, tmp->second);
+        next_opcode_generation();
     }
     else
     {
         opcode_t value;
 
-        if (auto it = instruction_map_.find(op_code); it != instruction_map_.end())
+        if (auto it = get_instruction_map().find(*op_code); it != get_instruction_map().end())
         {
-            value.machine_opcode = it->first;
+            value.machine_opcode = op_code;
             value.machine_source = it->second;
         }
         if (auto it = macros_.find(op_code); it != macros_.end())
@@ -486,13 +471,41 @@ void hlasm_context::add_mnemonic(id_index mnemo, id_index op_code)
             throw std::invalid_argument("undefined operation code");
 
         opcode_mnemo_.insert_or_assign(mnemo, std::move(value));
+        next_opcode_generation();
+    }
+}
+
+bool hlasm_context::has_mnemonics() const { return !opcode_mnemo_.empty(); }
+
+std::string hlasm_context::mnemonics_signature() const
+{
+    // macros are identified by the location of their definition, as the definition objects differ among contexts
+    std::vector<std::string> mnemonics;
+    for (const auto& [mnemo, opcode] : opcode_mnemo_)
+    {
+        std::string entry = *mnemo + '=';
+        if (opcode.machine_opcode)
+            entry += *opcode.machine_opcode;
+        if (const auto& macro = opcode.macro_opcode)
+            entry += '/' + *macro->id + '@' + macro->definition_location.file + ':'
+                + std::to_string(macro->definition_location.pos.line);
+        mnemonics.push_back(std::move(entry));
     }
+    std::sort(mnemonics.begin(), mnemonics.end());
+
+    std::string result;
+    for (const auto& entry : mnemonics)
+        result.append(entry).push_back(';');
+    return result;
 }
 
 void hlasm_context::remove_mnemonic(id_index mnemo)
 {
     if (opcode_mnemo_.find(mnemo) != opcode_mnemo_.end() || is_opcode(mnemo))
+    {
         opcode_mnemo_.insert_or_assign(mnemo, opcode_t());
+        next_opcode_generation();
+    }
     else
         throw std::invalid_argument("undefined operation code");
 }
@@ -504,9 +517,9 @@ opcode_t hlasm_context::get_operation_code(id_index symbol) const
 
     opcode_t value;
 
-    if (auto it = instruction_map_.find(symbol); it != instruction_map_.end())
+    if (auto it = get_instruction_map().find(*symbol); it != get_instruction_map().end())
     {
-        value.machine_opcode = it->first;
+        value.machine_opcode = symbol;
         value.machine_source = it->second;
     }
     if (auto it = macros_.find(symbol); it != macros_.end())
@@ -515,8 +528,12 @@ opcode_t hlasm_context::get_operation_code(id_index symbol) const
     return value;
 }
 
+std::uint64_t hlasm_context::opcode_generation() const { return opcode_generation_; }
+
+void hlasm_context::next_opcode_generation() { opcode_generation_ = ++opcode_generation_source; }
+
 SET_t hlasm_context::get_attribute_value_ca(
-    data_attr_kind attribute, var_sym_ptr var_symbol, std::vector<size_t> offset)
+    data_attr_kind attribute, variable_symbol* var_symbol, std::vector<size_t> offset)
 {
     switch (attribute)
     {
@@ -566,7 +583,7 @@ SET_t hlasm_context::get_attribute_value_ca(data_attr_kind attribute, const symb
     }
 }
 
-C_t hlasm_context::get_type_attr(var_sym_ptr var_symbol, const std::vector<size_t>& offset)
+C_t hlasm_context::get_type_attr(variable_symbol* var_symbol, const std::vector<size_t>& offset)
 {
     if (!var_symbol)
         return "U";
@@ -603,7 +620,7 @@ C_t hlasm_context::get_type_attr(var_sym_ptr var_symbol, const std::vector<size_
     if (res)
         return "N";
 
-    id_index symbol_name = ids_.add(std::move(value));
+    id_index symbol_name = ids_->add(std::move(value));
     auto tmp_symbol = ord_ctx.get_symbol(symbol_name);
 
     if (tmp_symbol)
@@ -614,14 +631,14 @@ C_t hlasm_context::get_type_attr(var_sym_ptr var_symbol, const std::vector<size_
 
 C_t hlasm_context::get_opcode_attr(id_index symbol)
 {
-    auto it = instruction_map_.find(symbol);
+    auto it = get_instruction_map().find(*symbol);
 
     auto mac_it = macros_.find(symbol);
 
     if (mac_it != macros_.end())
         return "M";
 
-    if (it != instruction_map_.end())
+    if (it != get_instruction_map().end())
     {
         auto& [opcode, type] = *it;
         switch (type)
@@ -649,6 +666,7 @@ const macro_definition& hlasm_context::add_macro(id_index name,
     label_storage labels,
     location definition_location)
 {
+    next_opcode_generation();
     return *macros_
                 .insert_or_assign(name,
                     std::make_shared<macro_definition>(name,
@@ -657,10 +675,17 @@ const macro_definition& hlasm_context::add_macro(id_index name,
                         std::move(definition),
                         std::move(copy_nests),
                         std::move(labels),
-                        std::move(definition_location)))
+                        std::move(definition_location),
+                        ids()))
                 .first->second.get();
 }
 
+void hlasm_context::add_macro(macro_def_ptr macro)
+{
+    next_opcode_generation();
+    macros_.insert_or_assign(macro->id, std::move(macro));
+}
+
 const hlasm_context::macro_storage& hlasm_context::macros() const { return macros_; }
 
 macro_def_ptr hlasm_context::get_macro_definition(id_index name) const
@@ -686,7 +711,14 @@ macro_invo_ptr hlasm_context::enter_macro(id_index name, macro_data_ptr label_pa
     assert(macro_def);
 
     auto invo((macro_def->call(std::move(label_param_data), std::move(params), ids().add("SYSLIST"))));
-    scope_stack_.emplace_back(invo, macro_def);
+
+    std::vector<var_sym_ptr> frame;
+    if (!frame_pool_.empty())
+    {
+        frame = std::move(frame_pool_.back());
+        frame_pool_.pop_back();
+    }
+    scope_stack_.emplace_back(invo, macro_def, std::move(frame));
     add_system_vars_to_scope();
 
     visited_files_.insert(macro_def->definition_location.file);
@@ -695,7 +727,11 @@ macro_invo_ptr hlasm_context::enter_macro(id_index name, macro_data_ptr label_pa
     return invo;
 }
 
-void hlasm_context::leave_macro() { scope_stack_.pop_back(); }
+void hlasm_context::leave_macro()
+{
+    frame_pool_.push_back(scope_stack_.back().release_frame());
+    scope_stack_.pop_back();
+}
 
 macro_invo_ptr hlasm_context::this_macro() const
 {
@@ -708,12 +744,21 @@ const std::string& hlasm_context::opencode_file_name() const { return source_sta
 
 const std::set<std::string>& hlasm_context::get_visited_files() { return visited_files_; }
 
+void hlasm_context::add_visited_file(std::string file_name) { visited_files_.insert(std::move(file_name)); }
+
 void hlasm_context::add_copy_member(id_index member, statement_block definition, location definition_location)
 {
-    copy_members_.try_emplace(member, member, std::move(definition), definition_location);
+    copy_members_.try_emplace(
+        member, std::make_shared<copy_member>(member, std::move(definition), definition_location));
     visited_files_.insert(std::move(definition_location.file));
 }
 
+void hlasm_context::add_copy_member(copy_member_ptr member)
+{
+    visited_files_.insert(member->definition_location.file);
+    copy_members_.try_emplace(member->name, std::move(member));
+}
+
 void hlasm_context::enter_copy_member(id_index member_name)
 {
     auto tmp = copy_members_.find(member_name);
@@ -722,7 +767,7 @@ void hlasm_context::enter_copy_member(id_index member_name)
 
     auto& [name, member] = *tmp;
 
-    source_stack_.back().copy_stack.emplace_back(member.enter());
+    source_stack_.back().copy_stack.emplace_back(member->enter());
 }
 
 const hlasm_context::copy_member_storage& hlasm_context::copy_members() { return copy_members_; }
@@ -742,7 +787,7 @@ void hlasm_context::apply_source_snapshot(source_snapshot snapshot)
 
     for (auto& frame : snapshot.copy_frames)
     {
-        auto invo = copy_members_.at(frame.copy_member).enter();
+        auto invo = copy_members_.at(frame.copy_member)->enter();
         invo.current_statement = (int)frame.statement_offset;
         source_stack_.back().copy_stack.push_back(std::move(invo));
     }
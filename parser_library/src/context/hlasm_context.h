@@ -15,9 +15,11 @@
 #ifndef CONTEXT_HLASM_CONTEXT_H
 #define CONTEXT_HLASM_CONTEXT_H
 
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <set>
+#include <string_view>
 #include <vector>
 
 #include "code_scope.h"
@@ -38,8 +40,8 @@ using ctx_ptr = std::unique_ptr<hlasm_context>;
 class hlasm_context
 {
     using macro_storage = std::unordered_map<id_index, macro_def_ptr>;
-    using copy_member_storage = std::unordered_map<id_index, copy_member>;
-    using instruction_storage = std::unordered_map<id_index, instruction::instruction_array>;
+    using copy_member_storage = std::unordered_map<id_index, copy_member_ptr>;
+    using instruction_storage = std::unordered_map<std::string_view, instruction::instruction_array>;
     using opcode_map = std::unordered_map<id_index, opcode_t>;
 
     // storage of global variables
@@ -50,11 +52,17 @@ class hlasm_context
     copy_member_storage copy_members_;
     // map of OPSYN mnemonics
     opcode_map opcode_mnemo_;
+    // identifies the state of OPSYN mnemonics and macro definitions, a new value is taken on each of their changes
+    // the values are unique among all contexts, as macro definitions with their caches can be shared by analyses
+    std::uint64_t opcode_generation_;
+    void next_opcode_generation();
     // storage of identifiers
-    id_storage ids_;
+    std::shared_ptr<id_storage> ids_;
 
     // stack of nested scopes
     std::deque<code_scope> scope_stack_;
+    // frames of finished macro invocations, kept to be reused by the following ones
+    std::vector<std::vector<var_sym_ptr>> frame_pool_;
     code_scope* curr_scope();
     const code_scope* curr_scope() const;
     // stack of statement processings
@@ -67,9 +75,8 @@ class hlasm_context
     // all files processes via macro or copy member invocation
     std::set<std::string> visited_files_;
 
-    // map of all instruction in HLASM
-    const instruction_storage instruction_map_;
-    instruction_storage init_instruction_map();
+    // map of all instruction in HLASM, shared by all contexts
+    static const instruction_storage& get_instruction_map();
 
     // value of system variable SYSNDX
     size_t SYSNDX_;
@@ -79,12 +86,16 @@ class hlasm_context
     bool is_opcode(id_index symbol) const;
 
 public:
-    hlasm_context(std::string file_name = "");
+    // creates context for the open code file
+    // identifier storage can be shared with other contexts, a new one is created when init_ids is empty
+    hlasm_context(std::string file_name = "", std::shared_ptr<id_storage> init_ids = nullptr);
 
     // gets name of file where is open-code located
     const std::string& opencode_file_name() const;
     // accesses visited files
     const std::set<std::string>& get_visited_files();
+    // marks file as visited without processing it
+    void add_visited_file(std::string file_name);
 
     // gets current source
     const source_context& current_source() const;
@@ -119,6 +130,7 @@ public:
 
     // index storage
     id_storage& ids();
+    std::shared_ptr<id_storage> ids_ptr();
 
     // map of instructions
     const instruction_storage& instruction_map() const;
@@ -135,8 +147,8 @@ public:
     const code_scope::set_sym_storage& globals() const;
 
     // return variable symbol in current scope
-    // returns empty shared_ptr if there is none in the current scope
-    var_sym_ptr get_var_sym(id_index name);
+    // returns nullptr if there is none in the current scope
+    variable_symbol* get_var_sym(id_index name);
 
     // registers sequence symbol
     void add_sequence_symbol(sequence_symbol_ptr seq_sym);
@@ -155,17 +167,23 @@ public:
     void add_mnemonic(id_index mnemo, id_index op_code);
     // removes opsyn mnemonic
     void remove_mnemonic(id_index mnemo);
+    // checks whether any operation code was changed via OPSYN
+    bool has_mnemonics() const;
+    // describes the operation codes changed via OPSYN, equal descriptions mean equal changes in any context
+    std::string mnemonics_signature() const;
 
     // checks wheter the symbol is an operation code (is a valid instruction or a mnemonic)
     opcode_t get_operation_code(id_index symbol) const;
+    // gets the generation of operation codes, results of their resolution are valid while it does not change
+    std::uint64_t opcode_generation() const;
 
     // get data attribute value of variable symbol
-    SET_t get_attribute_value_ca(data_attr_kind attribute, var_sym_ptr var_symbol, std::vector<size_t> offset);
+    SET_t get_attribute_value_ca(data_attr_kind attribute, variable_symbol* var_symbol, std::vector<size_t> offset);
     // get data attribute value of ordinary symbol
     SET_t get_attribute_value_ca(data_attr_kind attribute, id_index symbol);
     SET_t get_attribute_value_ca(data_attr_kind attribute, const symbol* symbol);
 
-    C_t get_type_attr(var_sym_ptr var_symbol, const std::vector<size_t>& offset);
+    C_t get_type_attr(variable_symbol* var_symbol, const std::vector<size_t>& offset);
     C_t get_opcode_attr(id_index symbol);
 
     // gets macro storage
@@ -183,6 +201,8 @@ public:
         copy_nest_storage copy_nests,
         label_storage labels,
         location definition_location);
+    // registers already created macro definition (e.g. one reused from a different context)
+    void add_macro(macro_def_ptr macro);
     // enters a macro with actual params
     macro_invo_ptr enter_macro(id_index name, macro_data_ptr label_param_data, std::vector<macro_arg> params);
     // leaves current macro
@@ -192,6 +212,8 @@ public:
     const copy_member_storage& copy_members();
     // registers new copy member
     void add_copy_member(id_index member, statement_block definition, location definition_location);
+    // registers already created copy member (e.g. one reused from a different context)
+    void add_copy_member(copy_member_ptr member);
     // enters a copy member
     void enter_copy_member(id_index member);
     // leaves current copy member
@@ -201,21 +223,20 @@ public:
     template<typename T>
     set_sym_ptr create_global_variable(id_index id, bool is_scalar)
     {
-        auto tmp = curr_scope()->variables.find(id);
-        if (tmp != curr_scope()->variables.end())
-            return tmp->second;
+        if (auto tmp = curr_scope()->find_set_symbol(id))
+            return tmp;
 
         auto glob = globals_.find(id);
         if (glob != globals_.end())
         {
-            curr_scope()->variables.insert({ id, glob->second });
+            curr_scope()->add_set_symbol(glob->second);
             return glob->second;
         }
 
         auto val = std::make_shared<set_symbol<T>>(id, is_scalar, true);
 
         globals_.insert({ id, val });
-        curr_scope()->variables.insert({ id, val });
+        curr_scope()->add_set_symbol(val);
 
         return val;
     }
@@ -224,14 +245,13 @@ public:
     template<typename T>
     set_sym_ptr create_local_variable(id_index id, bool is_scalar)
     {
-        auto tmp = curr_scope()->variables.find(id);
-        if (tmp != curr_scope()->variables.end())
-            return tmp->second;
+        if (auto tmp = curr_scope()->find_set_symbol(id))
+            return tmp;
 
 
         set_sym_ptr val(std::make_shared<set_symbol<T>>(id, is_scalar, false));
 
-        curr_scope()->variables.insert({ id, val });
+        curr_scope()->add_set_symbol(val);
 
         return val;
     }
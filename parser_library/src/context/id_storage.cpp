@@ -14,36 +14,63 @@
 
 #include "id_storage.h"
 
-#include "common_types.h"
-
 using namespace hlasm_plugin::parser_library::context;
 
+namespace {
+// identifiers are upper-cased the same way as by std::toupper in the "C" locale
+char upper_case(char c) { return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c; }
+} // namespace
+
 const std::string id_storage::empty_string_("");
 
 const id_storage::const_pointer id_storage::empty_id = &id_storage::empty_string_;
 
 hlasm_plugin::parser_library::context::id_storage::id_storage()
-    : well_known(lit_)
+    : well_known(*this)
 {}
 
-size_t id_storage::size() const { return lit_.size(); }
+size_t id_storage::size() const
+{
+    std::lock_guard guard(mutex_);
+    return lit_.size();
+}
 
 id_storage::const_iterator id_storage::begin() const { return lit_.begin(); }
 
 id_storage::const_iterator id_storage::end() const { return lit_.end(); }
 
-bool id_storage::empty() const { return lit_.empty(); }
-
-id_storage::const_pointer id_storage::find(std::string val) const
+bool id_storage::empty() const
 {
-    to_upper(val);
+    std::lock_guard guard(mutex_);
+    return lit_.empty();
+}
 
+id_storage::const_pointer id_storage::find(std::string_view val) const
+{
     if (val.empty())
         return empty_id;
 
-    const_iterator tmp = lit_.find(val);
-
-    return tmp == lit_.end() ? nullptr : &*tmp;
+    char short_id[short_id_size];
+    std::string long_id;
+    std::string_view key;
+    if (val.size() <= short_id_size)
+    {
+        for (size_t i = 0; i < val.size(); ++i)
+            short_id[i] = upper_case(val[i]);
+        key = std::string_view(short_id, val.size());
+    }
+    else
+    {
+        long_id = val;
+        for (auto& c : long_id)
+            c = upper_case(c);
+        key = long_id;
+    }
+
+    std::lock_guard guard(mutex_);
+    auto tmp = index_.find(key);
+
+    return tmp == index_.end() ? nullptr : tmp->second;
 }
 
 id_storage::const_pointer id_storage::add(std::string value, bool is_uri)
@@ -51,24 +78,36 @@ id_storage::const_pointer id_storage::add(std::string value, bool is_uri)
     if (value.empty())
         return empty_id;
     if (!is_uri)
-        to_upper(value);
-    return &*lit_.insert(std::move(value)).first;
+        for (auto& c : value)
+            c = upper_case(c);
+
+    std::lock_guard guard(mutex_);
+    return insert(std::move(value));
+}
+
+const std::string* id_storage::insert(std::string value)
+{
+    if (auto found = index_.find(value); found != index_.end())
+        return found->second;
+
+    const std::string& stored = lit_.emplace_back(std::move(value));
+    index_.emplace(stored, &stored);
+    return &stored;
 }
 
-hlasm_plugin::parser_library::context::id_storage::well_known_strings::well_known_strings(
-    std::unordered_set<std::string>& ptr)
-    : COPY(&*ptr.emplace("COPY").first)
-    , SETA(&*ptr.emplace("SETA").first)
-    , SETB(&*ptr.emplace("SETB").first)
-    , SETC(&*ptr.emplace("SETC").first)
-    , GBLA(&*ptr.emplace("GBLA").first)
-    , GBLB(&*ptr.emplace("GBLB").first)
-    , GBLC(&*ptr.emplace("GBLC").first)
-    , LCLA(&*ptr.emplace("LCLA").first)
-    , LCLB(&*ptr.emplace("LCLB").first)
-    , LCLC(&*ptr.emplace("LCLC").first)
-    , MACRO(&*ptr.emplace("MACRO").first)
-    , MEND(&*ptr.emplace("MEND").first)
-    , ASPACE(&*ptr.emplace("ASPACE").first)
-    , empty(&*ptr.emplace("").first)
+hlasm_plugin::parser_library::context::id_storage::well_known_strings::well_known_strings(id_storage& storage)
+    : COPY(storage.insert("COPY"))
+    , SETA(storage.insert("SETA"))
+    , SETB(storage.insert("SETB"))
+    , SETC(storage.insert("SETC"))
+    , GBLA(storage.insert("GBLA"))
+    , GBLB(storage.insert("GBLB"))
+    , GBLC(storage.insert("GBLC"))
+    , LCLA(storage.insert("LCLA"))
+    , LCLB(storage.insert("LCLB"))
+    , LCLC(storage.insert("LCLC"))
+    , MACRO(storage.insert("MACRO"))
+    , MEND(storage.insert("MEND"))
+    , ASPACE(storage.insert("ASPACE"))
+    , empty(storage.insert(""))
 {}
@@ -15,7 +15,11 @@
 #ifndef CONTEXT_LITERAL_STORAGE_H
 #define CONTEXT_LITERAL_STORAGE_H
 
+#include <deque>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace hlasm_plugin {
@@ -25,16 +29,26 @@ namespace context {
 
 // storage for identifiers
 // changes strings of identifiers to indexes of this storage class for easier and unified work
+// the storage can be shared by analyses running in parallel, hence the lookups and insertions are synchronized
 class id_storage
 {
 private:
-    std::unordered_set<std::string> lit_;
+    // identifiers are stored in blocks, their addresses never change
+    std::deque<std::string> lit_;
+    // lookup of identifiers by views into lit_, so that searching does not allocate
+    std::unordered_map<std::string_view, const std::string*> index_;
+    mutable std::mutex mutex_;
     static const std::string empty_string_;
 
+    // identifiers longer than this are upper-cased in a temporary string when searched
+    static constexpr size_t short_id_size = 64;
+
+    const std::string* insert(std::string value);
+
 public:
     id_storage();
     using const_pointer = const std::string*;
-    using const_iterator = typename std::unordered_set<std::string>::const_iterator;
+    using const_iterator = typename std::deque<std::string>::const_iterator;
 
     // represents value of empty identifier
     static const const_pointer empty_id;
@@ -44,7 +58,7 @@ public:
     const_iterator end() const;
     bool empty() const;
 
-    const_pointer find(std::string val) const;
+    const_pointer find(std::string_view val) const;
 
     const_pointer add(std::string value, bool is_uri = false);
 
@@ -64,7 +78,7 @@ public:
         const std::string* MEND;
         const std::string* ASPACE;
         const std::string* empty;
-        well_known_strings(std::unordered_set<std::string>& ptr);
+        well_known_strings(id_storage& storage);
 
     } const well_known;
 };
@@ -14,6 +14,7 @@
 
 #include "lsp_context.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "ebcdic_encoding.h"
@@ -213,3 +214,173 @@ void completion_item_s::implode_contents()
         content_string = result.str();
     }
 }
+
+namespace {
+template<class T>
+void count_occurences(std::unordered_map<T, size_t, hash_function<T>>& counts, const definitions<T>& symbols)
+{
+    counts.reserve(symbols.size());
+    for (const auto& [symbol, occurences] : symbols)
+        counts.emplace(symbol, occurences.size());
+}
+
+template<class T>
+size_t previous_count(const std::unordered_map<T, size_t, hash_function<T>>& counts, const T& symbol)
+{
+    auto found = counts.find(symbol);
+    return found == counts.end() ? 0 : found->second;
+}
+
+template<class T>
+lsp_context_delta::entries<T> added_occurences(
+    const std::unordered_map<T, size_t, hash_function<T>>& counts, const definitions<T>& symbols)
+{
+    lsp_context_delta::entries<T> result;
+    for (const auto& [symbol, occurences] : symbols)
+    {
+        auto count = previous_count(counts, symbol);
+        if (occurences.size() > count)
+            result.emplace_back(symbol, std::vector<occurence>(occurences.begin() + count, occurences.end()));
+    }
+    return result;
+}
+
+completion_item_s copy_contents(const completion_item_s& item)
+{
+    return completion_item_s(item.label, item.detail, item.insert_text, item.get_contents(), item.kind);
+}
+
+bool same_occurence(const occurence& occ, const instr_definition& statement)
+{
+    return occ.file_name == statement.file_name && occ.symbol_range == statement.definition_range;
+}
+
+// the latest version of the macro in the context, or nullopt if there is none
+std::optional<size_t> latest_version(const lsp_context& ctx, instr_definition symbol)
+{
+    std::optional<size_t> result;
+    for (symbol.version = 0; ctx.instructions.find(symbol) != ctx.instructions.end(); ++symbol.version)
+        result = symbol.version;
+    return result;
+}
+} // namespace
+
+lsp_context_snapshot::lsp_context_snapshot(const lsp_context& ctx)
+    : ctx_(ctx)
+    , all_instructions_(ctx.all_instructions.size())
+    , deferred_macro_statement_(ctx.deferred_macro_statement)
+{
+    count_occurences(seq_symbols_, ctx.seq_symbols);
+    count_occurences(var_symbols_, ctx.var_symbols);
+    count_occurences(ord_symbols_, ctx.ord_symbols);
+    count_occurences(instructions_, ctx.instructions);
+}
+
+lsp_context_delta lsp_context_snapshot::changes() const
+{
+    lsp_context_delta result;
+    result.seq_symbols = added_occurences(seq_symbols_, ctx_.seq_symbols);
+    result.var_symbols = added_occurences(var_symbols_, ctx_.var_symbols);
+    result.ord_symbols = added_occurences(ord_symbols_, ctx_.ord_symbols);
+
+    for (auto& [symbol, occurences] : added_occurences(instructions_, ctx_.instructions))
+    {
+        auto& entry = symbol.version != (size_t)-1 && instructions_.find(symbol) == instructions_.end()
+            ? result.defined_instructions.emplace_back(std::move(symbol), std::move(occurences))
+            : result.used_instructions.emplace_back(std::move(symbol), std::move(occurences));
+        if (entry.first.item)
+            entry.first.item = copy_contents(*entry.first.item);
+    }
+
+    // the statement that used the macro before its definition belongs to the context, not to the member
+    if (deferred_macro_statement_.name != ctx_.deferred_macro_statement.name)
+    {
+        for (auto& [symbol, occurences] : result.defined_instructions)
+            if (symbol.name == deferred_macro_statement_.name)
+                occurences.erase(std::remove_if(occurences.begin(),
+                                     occurences.end(),
+                                     [this](const auto& occ) { return same_occurence(occ, deferred_macro_statement_); }),
+                    occurences.end());
+
+        if (ctx_.deferred_macro_statement.name && !ctx_.deferred_macro_statement.name->empty())
+            result.deferred_macro_statement = ctx_.deferred_macro_statement;
+    }
+
+    for (size_t i = all_instructions_; i < ctx_.all_instructions.size(); ++i)
+        result.all_instructions.push_back(copy_contents(ctx_.all_instructions[i]));
+
+    return result;
+}
+
+void hlasm_plugin::parser_library::context::add_lsp_changes(
+    lsp_context& ctx, const lsp_context_delta& delta, const std::string* empty_string)
+{
+    // versions of the macros defined by the member in the parsed and in this context
+    std::vector<std::pair<macro_id, macro_id>> versions;
+    auto added_version = [&versions](const macro_id& scope) -> std::optional<macro_id> {
+        for (const auto& [parsed, added] : versions)
+            if (parsed == scope)
+                return added;
+        return std::nullopt;
+    };
+    auto in_context = [&added_version](const macro_id& scope) { return added_version(scope).value_or(scope); };
+
+    for (const auto& [symbol, occurences] : delta.defined_instructions)
+    {
+        auto definition = symbol;
+        definition.version = 0;
+        while (ctx.instructions.find(definition) != ctx.instructions.end())
+            ++definition.version;
+        versions.emplace_back(macro_id { symbol.name, symbol.version }, macro_id { symbol.name, definition.version });
+
+        auto& added = ctx.instructions[definition];
+        added.insert(added.end(), occurences.begin(), occurences.end());
+        if (ctx.deferred_macro_statement.name == definition.name)
+        {
+            added.emplace_back(ctx.deferred_macro_statement.definition_range, ctx.deferred_macro_statement.file_name);
+            ctx.deferred_macro_statement.clear(empty_string);
+        }
+    }
+
+    for (const auto& [symbol, occurences] : delta.used_instructions)
+    {
+        auto used = symbol;
+        // macros defined outside of the member are used in their latest version
+        if (used.version != (size_t)-1)
+        {
+            if (auto defined = added_version({ used.name, used.version }))
+                used.version = defined->version;
+            else if (auto latest = latest_version(ctx, used))
+                used.version = *latest;
+        }
+        auto& added = ctx.instructions[used];
+        added.insert(added.end(), occurences.begin(), occurences.end());
+    }
+
+    for (const auto& [symbol, occurences] : delta.seq_symbols)
+    {
+        auto seq = symbol;
+        seq.scope = in_context(seq.scope);
+        auto& added = ctx.seq_symbols[seq];
+        added.insert(added.end(), occurences.begin(), occurences.end());
+    }
+
+    for (const auto& [symbol, occurences] : delta.var_symbols)
+    {
+        auto var = symbol;
+        var.scope = in_context(var.scope);
+        auto& added = ctx.var_symbols[var];
+        added.insert(added.end(), occurences.begin(), occurences.end());
+    }
+
+    for (const auto& [symbol, occurences] : delta.ord_symbols)
+    {
+        auto& added = ctx.ord_symbols[symbol];
+        added.insert(added.end(), occurences.begin(), occurences.end());
+    }
+
+    ctx.all_instructions.insert(ctx.all_instructions.end(), delta.all_instructions.begin(), delta.all_instructions.end());
+
+    if (delta.deferred_macro_statement)
+        ctx.deferred_macro_statement = *delta.deferred_macro_statement;
+}
@@ -18,6 +18,8 @@
 #include <optional>
 #include <stack>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "context/ordinary_assembly/symbol.h"
 #include "semantics/highlighting_info.h"
@@ -362,5 +364,49 @@ struct lsp_context
 };
 
 using lsp_ctx_ptr = std::shared_ptr<lsp_context>;
+
+// LSP information that the parsing of a library member added to a context,
+// it can be added to other contexts that share the identifier storage without parsing the member again
+struct lsp_context_delta
+{
+    template<class T>
+    using entries = std::vector<std::pair<T, std::vector<occurence>>>;
+
+    entries<seq_definition> seq_symbols;
+    entries<var_definition> var_symbols;
+    entries<ord_definition> ord_symbols;
+    // macros defined by the member, their versions are assigned again in the context they are added to
+    entries<instr_definition> defined_instructions;
+    // occurences of other instructions
+    entries<instr_definition> used_instructions;
+    std::vector<completion_item_s> all_instructions;
+    // instruction used before its definition that was left undefined by the member
+    std::optional<instr_definition> deferred_macro_statement;
+};
+
+// state of the context before a library member is parsed, the information added later is extracted from it
+class lsp_context_snapshot
+{
+    template<class T>
+    using counts = std::unordered_map<T, size_t, hash_function<T>>;
+
+    const lsp_context& ctx_;
+    counts<seq_definition> seq_symbols_;
+    counts<var_definition> var_symbols_;
+    counts<ord_definition> ord_symbols_;
+    counts<instr_definition> instructions_;
+    size_t all_instructions_;
+    instr_definition deferred_macro_statement_;
+
+public:
+    explicit lsp_context_snapshot(const lsp_context& ctx);
+
+    // returns the information added to the context since the snapshot was taken,
+    // the contents of the completion items are copied as they may point into the text of the member
+    lsp_context_delta changes() const;
+};
+
+// adds the information into the context the same way the parsing of the member does
+void add_lsp_changes(lsp_context& ctx, const lsp_context_delta& delta, const std::string* empty_string);
 } // namespace hlasm_plugin::parser_library::context
 #endif
\ No newline at end of file
@@ -17,25 +17,42 @@
 #include <cassert>
 #include <stdexcept>
 
+#include "processing/statement.h"
+#include "semantics/concatenation_term.h"
+#include "semantics/statement.h"
 #include "variables/system_variable.h"
 
 using namespace hlasm_plugin::parser_library;
 using namespace hlasm_plugin::parser_library::context;
 
-
+namespace {
+bool is_ord_char(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '$' || c == '#'
+        || c == '@' || c == '_';
+}
+} // namespace
 
 const std::unordered_map<id_index, const macro_param_base*>& macro_definition::named_params() const
 {
     return named_params_;
 }
 
+const std::vector<std::unique_ptr<positional_param>>& macro_definition::positional_params() const
+{
+    return positional_params_;
+}
+
+const std::vector<std::unique_ptr<keyword_param>>& macro_definition::keyword_params() const { return keyword_params_; }
+
 macro_definition::macro_definition(id_index name,
     id_index label_param_name,
     std::vector<macro_arg> params,
     statement_block definition,
     copy_nest_storage copy_nests,
     label_storage labels,
-    location definition_location)
+    location definition_location,
+    id_storage& ids)
     : label_param_name_(label_param_name)
     , id(name)
     , copy_nests(std::move(copy_nests))
@@ -83,13 +100,79 @@ macro_definition::macro_definition(id_index name,
             ++idx;
         }
     }
+
+    for (const auto& param : positional_params_)
+        if (param)
+            add_variable_slot(param->id);
+    for (const auto& param : keyword_params_)
+        add_variable_slot(param->id);
+    param_slots_ = variable_slots_.size();
+
+    // local variable symbols get the slots of the names written in the definition
+    for (const auto& stmt : cached_definition)
+    {
+        auto base = stmt.get_base();
+        const semantics::label_si* label;
+        if (auto deferred = base->access_deferred())
+        {
+            label = &deferred->label_ref();
+            add_variable_slots(deferred->deferred_ref(), ids);
+        }
+        else
+            label = &base->access_resolved()->label_ref();
+
+        if (label->type == semantics::label_si_type::VAR)
+        {
+            if (auto var = std::get<semantics::vs_ptr>(label->value)->access_basic())
+                add_variable_slot(var->name);
+        }
+        else if (label->type == semantics::label_si_type::CONC)
+        {
+            for (const auto& point : std::get<semantics::concat_chain>(label->value))
+                if (auto var = point->access_var(); var && var->symbol->access_basic())
+                    add_variable_slot(var->symbol->access_basic()->name);
+        }
+    }
 }
 
+void macro_definition::add_variable_slot(id_index name) { variable_slots_.try_emplace(name, variable_slots_.size()); }
+
+void macro_definition::add_variable_slots(const std::string& text, id_storage& ids)
+{
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] != '&')
+            continue;
+
+        size_t end = i + 1;
+        while (end < text.size() && is_ord_char(text[end]))
+            ++end;
+
+        // the double ampersand stands for the ampersand character
+        if (end < text.size() && end == i + 1 && text[end] == '&')
+            ++end;
+        else if (end > i + 1 && end - i <= 64 && !(text[i + 1] >= '0' && text[i + 1] <= '9'))
+            add_variable_slot(ids.add(text.substr(i + 1, end - i - 1)));
+
+        i = end - 1;
+    }
+}
+
+size_t macro_definition::variable_slot(id_index name) const
+{
+    auto it = variable_slots_.find(name);
+    return it == variable_slots_.end() ? no_slot : it->second;
+}
+
+size_t macro_definition::frame_size() const { return variable_slots_.size(); }
+
 macro_invo_ptr macro_definition::call(
     macro_data_ptr label_param_data, std::vector<macro_arg> actual_params, id_index syslist_name)
 {
     std::vector<macro_data_ptr> syslist;
-    std::unordered_map<id_index, macro_param_ptr> named_cpy;
+    // params are stored in their slots, the first one with the name is used
+    std::vector<macro_param_ptr> params(param_slots_);
+    auto param_slot = [this, &params](id_index name) -> macro_param_ptr& { return params[variable_slot(name)]; };
 
     if (label_param_data)
         syslist.push_back(std::move(label_param_data));
@@ -98,8 +181,8 @@ macro_invo_ptr macro_definition::call(
 
     if (positional_params_[0])
     {
-        named_cpy.emplace(positional_params_[0]->id,
-            std::make_unique<positional_param>(positional_params_[0]->id, 0, *syslist.back()));
+        param_slot(positional_params_[0]->id) =
+            std::make_shared<positional_param>(positional_params_[0]->id, 0, *syslist.back());
     }
 
     for (auto&& param : actual_params)
@@ -113,17 +196,16 @@ macro_invo_ptr macro_definition::call(
 
             auto key_par = dynamic_cast<const keyword_param*>(tmp->second);
             assert(key_par);
-            named_cpy.emplace(
-                param.id, std::make_unique<keyword_param>(param.id, key_par->default_data, std::move(param.data)));
+            if (auto& slot = param_slot(param.id); !slot)
+                slot = std::make_shared<keyword_param>(param.id, key_par->default_data, std::move(param.data));
         }
         else
         {
             if (positional_params_.size() > syslist.size() && positional_params_[syslist.size()])
             {
-                named_cpy.emplace(positional_params_[syslist.size()]->id,
-                    std::make_unique<positional_param>(positional_params_[syslist.size()]->id,
-                        positional_params_[syslist.size()]->position,
-                        *param.data));
+                const auto& pos_par = positional_params_[syslist.size()];
+                if (auto& slot = param_slot(pos_par->id); !slot)
+                    slot = std::make_shared<positional_param>(pos_par->id, pos_par->position, *param.data);
             }
             syslist.push_back(move(param.data));
         }
@@ -133,26 +215,22 @@ macro_invo_ptr macro_definition::call(
     {
         if (positional_params_[i])
         {
-            named_cpy.emplace(positional_params_[i]->id,
-                std::make_unique<positional_param>(
-                    positional_params_[i]->id, positional_params_[i]->position, *macro_param_data_component::dummy));
+            if (auto& slot = param_slot(positional_params_[i]->id); !slot)
+                slot = std::make_shared<positional_param>(
+                    positional_params_[i]->id, positional_params_[i]->position, *macro_param_data_component::dummy);
         }
     }
     for (auto&& key_par : keyword_params_)
     {
-        if (named_cpy.find(key_par->id) == named_cpy.end())
-        {
-            named_cpy.emplace(
-                key_par->id, std::make_unique<keyword_param>(key_par->id, key_par->default_data, nullptr));
-        }
+        if (auto& slot = param_slot(key_par->id); !slot)
+            slot = std::make_shared<keyword_param>(key_par->id, key_par->default_data, nullptr);
     }
 
-    named_cpy.emplace(syslist_name,
-        std::make_unique<system_variable>(
-            syslist_name, std::make_unique<macro_param_data_composite>(std::move(syslist)), false));
+    params.push_back(std::make_shared<system_variable>(
+        syslist_name, std::make_unique<macro_param_data_composite>(std::move(syslist)), false));
 
     return std::make_shared<macro_invocation>(
-        id, cached_definition, copy_nests, labels, std::move(named_cpy), definition_location);
+        id, cached_definition, copy_nests, labels, std::move(params), definition_location);
 }
 
 bool macro_definition::operator=(const macro_definition& m) { return id == m.id; }
@@ -161,13 +239,21 @@ macro_invocation::macro_invocation(id_index name,
     cached_block& cached_definition,
     const copy_nest_storage& copy_nests,
     const label_storage& labels,
-    std::unordered_map<id_index, macro_param_ptr> named_params,
+    std::vector<macro_param_ptr> params,
     const location& definition_location)
     : id(name)
-    , named_params(std::move(named_params))
+    , params(std::move(params))
     , cached_definition(cached_definition)
     , copy_nests(copy_nests)
     , labels(labels)
     , definition_location(definition_location)
     , current_statement(-1)
 {}
+
+macro_param_base* macro_invocation::find_param(id_index name) const
+{
+    for (const auto& param : params)
+        if (param->id == name)
+            return param.get();
+    return nullptr;
+}
@@ -62,12 +62,23 @@ class macro_definition
     std::vector<std::unique_ptr<keyword_param>> keyword_params_;
     std::unordered_map<id_index, const macro_param_base*> named_params_;
     const id_index label_param_name_;
+    // slots of the variable symbols in the frames of invocations
+    std::unordered_map<id_index, size_t> variable_slots_;
+    // params take the first slots
+    size_t param_slots_;
+
+    void add_variable_slot(id_index name);
+    void add_variable_slots(const std::string& text, id_storage& ids);
 
 public:
     // identifier of macro
     const id_index id;
     // params of macro
     const std::unordered_map<id_index, const macro_param_base*>& named_params() const;
+    // positional params in the order of their positions, the first one is the label param (nullptr when not present)
+    const std::vector<std::unique_ptr<positional_param>>& positional_params() const;
+    // keyword params together with their default values
+    const std::vector<std::unique_ptr<keyword_param>>& keyword_params() const;
     // vector of statements representing macro definition
     std::vector<cached_statement_storage> cached_definition;
     // vector assigning each statement its copy nest
@@ -77,13 +88,23 @@ public:
     // location of the macro definition in code
     const location definition_location;
     // initializes macro with its name and params - positional or keyword
+    // the variable symbols used in the definition are assigned their slots, identifiers are added to the storage
     macro_definition(id_index name,
         id_index label_param_name,
         std::vector<macro_arg> params,
         statement_block definition,
         copy_nest_storage copy_nests,
         label_storage labels,
-        location definition_location);
+        location definition_location,
+        id_storage& ids);
+
+    // value of variable_slot for variable symbols without a slot
+    static constexpr size_t no_slot = (size_t)-1;
+    // returns the slot of the variable symbol in the frames of invocations
+    // symbols not written in the definition (e.g. created ones) have no slot
+    size_t variable_slot(id_index name) const;
+    // number of slots of the frames of invocations
+    size_t frame_size() const;
 
     // returns object with parameters' data set to actual parameters in macro call
     macro_invo_ptr call(macro_data_ptr label_param_data, std::vector<macro_arg> actual_params, id_index syslist_name);
@@ -99,8 +120,8 @@ struct macro_invocation
 public:
     // identifier of macro
     const id_index id;
-    // params of macro
-    const std::unordered_map<id_index, macro_param_ptr> named_params;
+    // params of macro, including SYSLIST
+    const std::vector<macro_param_ptr> params;
     // vector of statements representing macro definition
     cached_block& cached_definition;
     // vector assigning each statement its copy nest
@@ -116,8 +137,11 @@ public:
         cached_block& cached_definition,
         const copy_nest_storage& copy_nests,
         const label_storage& labels,
-        std::unordered_map<id_index, macro_param_ptr> named_params,
+        std::vector<macro_param_ptr> params,
         const location& definition_location);
+
+    // returns the param with the name, nullptr when there is no such param
+    macro_param_base* find_param(id_index name) const;
 };
 
 } // namespace context
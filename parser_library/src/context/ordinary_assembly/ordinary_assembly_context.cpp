@@ -45,6 +45,8 @@ bool ordinary_assembly_context::create_symbol(
 
     bool ok = true;
 
+    symbol_dependencies.add_defined_symbol(name);
+
     if (value.value_kind() == symbol_value_kind::RELOC)
         ok = symbol_dependencies.check_loctr_cycle();
 
@@ -96,6 +98,7 @@ void ordinary_assembly_context::set_section(id_index name, const section_kind ki
 
         auto tmp_addr = curr_section_->current_location_counter().current_address();
         symbols_.try_emplace(name, name, tmp_addr, symbol_attributes::make_section_attrs(), std::move(symbol_location));
+        symbol_dependencies.add_defined_symbol(name);
     }
 }
 
@@ -125,6 +128,7 @@ void ordinary_assembly_context::set_location_counter(id_index name, location sym
             name, name, tmp_addr, symbol_attributes::make_section_attrs(), std::move(symbol_location));
         if (!sym_tmp.second)
             throw std::invalid_argument("symbol already defined");
+        symbol_dependencies.add_defined_symbol(name);
     }
 }
 
@@ -33,11 +33,16 @@ bool symbol_dependency_tables::check_cycle(dependant target, std::vector<dependa
         return false;
     }
 
+    std::unordered_set<dependant> visited;
+
     while (!dependencies.empty())
     {
         auto top_dep = std::move(dependencies.back());
         dependencies.pop_back();
 
+        if (!visited.insert(top_dep).second)
+            continue;
+
         const resolvable* dep_src = nullptr;
 
         if (auto it = dependencies_.find(top_dep); it != dependencies_.end())
@@ -45,7 +50,7 @@ bool symbol_dependency_tables::check_cycle(dependant target, std::vector<dependa
         else
             continue;
 
-        for (auto&& dep : extract_dependencies(dep_src))
+        for (auto&& dep : current_dependencies(top_dep, dep_src))
         {
             if (dep == target)
             {
@@ -125,42 +130,50 @@ void symbol_dependency_tables::resolve_dependant_default(dependant target)
         if (ref.attribute == data_attr_kind::S)
             tmp_sym->set_scale(0);
     }
+    wake_dependants(target);
 }
 
 void symbol_dependency_tables::resolve(loctr_dependency_resolver* resolver)
 {
-    bool defined = true;
-    std::vector<dependant> to_delete;
+    std::vector<dependant> skipped;
 
-    while (defined)
-    {
-        defined = false;
-        for (auto& [target, dep_src] : dependencies_)
-        {
-            // resolve only symbol dependencies when resolver is not present
-            if (resolver == nullptr && target.kind() == dependant_kind::SPACE)
-                continue;
-
-            if (extract_dependencies(dep_src).empty()) // target no longer dependent on anything
-            {
-                to_delete.push_back(target);
+    wake_resolved_spaces();
 
-                resolve_dependant(target, dep_src, resolver); // resolve target
+    while (!ready_.empty())
+    {
+        auto target = std::move(ready_.back());
+        ready_.pop_back();
 
-                defined = true; // another defined target => iterate again
+        auto it = dependencies_.find(target);
+        if (it == dependencies_.end()) // already resolved
+            continue;
 
-                break;
-            }
+        // resolve only symbol dependencies when resolver is not present
+        if (resolver == nullptr && target.kind() == dependant_kind::SPACE)
+        {
+            skipped.push_back(std::move(target));
+            continue;
         }
 
-        for (auto del : to_delete)
+        auto dep_src = it->second;
+        if (auto deps = extract_dependencies(dep_src); !deps.empty()) // target still dependent
         {
-            dependencies_.erase(del);
-            try_erase_source_statement(del);
+            wait_for(std::move(target), std::move(deps));
+            continue;
         }
 
-        to_delete.clear();
+        // resolving may register new dependencies and invalidate the iterator, so the target is erased by key
+        resolve_dependant(target, dep_src, resolver);
+        dependencies_.erase(target);
+        try_erase_source_statement(target);
+        wake_dependants(target);
+
+        // spaces can be resolved by the location counters as a side effect
+        if (ready_.empty())
+            wake_resolved_spaces();
     }
+
+    ready_.insert(ready_.end(), std::make_move_iterator(skipped.begin()), std::make_move_iterator(skipped.end()));
 }
 
 std::vector<dependant> symbol_dependency_tables::extract_dependencies(const resolvable* dependency_source)
@@ -209,6 +222,94 @@ std::vector<dependant> symbol_dependency_tables::extract_dependencies(
     return ret;
 }
 
+std::vector<dependant> symbol_dependency_tables::current_dependencies(
+    const dependant& target, const resolvable* dependency_source)
+{
+    // defined symbols and spaces never become undefined again, so the extracted list stays valid
+    if (auto it = last_dependencies_.find(target); it != last_dependencies_.end())
+        if (std::all_of(it->second.begin(), it->second.end(), [this](const auto& dep) { return is_undefined(dep); }))
+            return it->second;
+
+    return extract_dependencies(dependency_source);
+}
+
+bool symbol_dependency_tables::is_undefined(const dependant& dep) const
+{
+    if (dep.kind() == dependant_kind::SPACE)
+        return !std::get<space_ptr>(dep.value)->resolved();
+
+    if (dep.kind() == dependant_kind::SYMBOL)
+    {
+        auto sym = sym_ctx_.get_symbol(std::get<id_index>(dep.value));
+        return sym == nullptr || sym->kind() == symbol_value_kind::UNDEF;
+    }
+
+    auto ref = std::get<attr_ref>(dep.value);
+    auto sym = sym_ctx_.get_symbol(ref.symbol_id);
+    return sym == nullptr || !sym->attributes().is_defined(ref.attribute);
+}
+
+void symbol_dependency_tables::wait_for(dependant target, std::vector<dependant> dependencies)
+{
+    if (dependencies.empty())
+    {
+        ready_.push_back(std::move(target));
+        return;
+    }
+
+    for (const auto& dep : dependencies)
+    {
+        if (dep.kind() == dependant_kind::SPACE)
+            space_waiters_[std::get<space_ptr>(dep.value)].insert(target);
+        else if (dep.kind() == dependant_kind::SYMBOL)
+            symbol_waiters_[std::get<id_index>(dep.value)].insert(target);
+        else
+            symbol_waiters_[std::get<attr_ref>(dep.value).symbol_id].insert(target);
+    }
+
+    last_dependencies_.insert_or_assign(std::move(target), std::move(dependencies));
+}
+
+void symbol_dependency_tables::wake_dependants(const dependant& defined)
+{
+    if (defined.kind() == dependant_kind::SPACE)
+    {
+        if (auto it = space_waiters_.find(std::get<space_ptr>(defined.value)); it != space_waiters_.end())
+        {
+            wake(it->second);
+            space_waiters_.erase(it);
+        }
+        return;
+    }
+
+    auto symbol = defined.kind() == dependant_kind::SYMBOL ? std::get<id_index>(defined.value)
+                                                           : std::get<attr_ref>(defined.value).symbol_id;
+    add_defined_symbol(symbol);
+}
+
+void symbol_dependency_tables::wake(std::unordered_set<dependant>& waiters)
+{
+    // the reverse edges are not removed when a dependant is woken by another dependency,
+    // only the dependants that still wait are moved to the ready queue
+    for (const auto& waiter : waiters)
+        if (last_dependencies_.erase(waiter))
+            ready_.push_back(waiter);
+}
+
+void symbol_dependency_tables::wake_resolved_spaces()
+{
+    for (auto it = space_waiters_.begin(); it != space_waiters_.end();)
+    {
+        if (it->first->resolved())
+        {
+            wake(it->second);
+            it = space_waiters_.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
 void symbol_dependency_tables::try_erase_source_statement(dependant index)
 {
     auto ait = dependency_source_addrs_.find(index);
@@ -239,11 +340,10 @@ bool symbol_dependency_tables::add_dependency(
     if (dependencies_.find(target) != dependencies_.end())
         throw std::invalid_argument("symbol dependency already present");
 
+    auto dependencies = extract_dependencies(dependency_source);
 
     if (check_for_cycle)
     {
-        auto dependencies = extract_dependencies(dependency_source);
-
         bool no_cycle = check_cycle(target, dependencies);
         if (!no_cycle)
         {
@@ -253,6 +353,7 @@ bool symbol_dependency_tables::add_dependency(
     }
 
     dependencies_.emplace(target, dependency_source);
+    wait_for(std::move(target), std::move(dependencies));
 
     return true;
 }
@@ -309,7 +410,7 @@ bool symbol_dependency_tables::check_cycle(space_ptr target)
     if (dep_src == dependencies_.end())
         return true;
 
-    bool no_cycle = check_cycle(target, extract_dependencies(dep_src->second));
+    bool no_cycle = check_cycle(target, current_dependencies(target, dep_src->second));
 
     if (!no_cycle)
         resolve(nullptr);
@@ -329,6 +430,15 @@ dependency_adder symbol_dependency_tables::add_dependencies(post_stmt_ptr depend
     return dependency_adder(*this, std::move(dependency_source_stmt));
 }
 
+void symbol_dependency_tables::add_defined_symbol(id_index symbol)
+{
+    if (auto it = symbol_waiters_.find(symbol); it != symbol_waiters_.end())
+    {
+        wake(it->second);
+        symbol_waiters_.erase(it);
+    }
+}
+
 void symbol_dependency_tables::add_defined(loctr_dependency_resolver* resolver) { resolve(resolver); }
 
 bool symbol_dependency_tables::check_loctr_cycle()
@@ -346,7 +456,7 @@ bool symbol_dependency_tables::check_loctr_cycle()
     {
         if (target.kind() == dependant_kind::SPACE)
         {
-            auto new_deps = extract_dependencies(dep_src);
+            auto new_deps = current_dependencies(target, dep_src);
             if (!new_deps.empty() && new_deps.front().kind() == dependant_kind::SYMBOL)
                 continue;
             else
@@ -424,6 +534,7 @@ bool symbol_dependency_tables::check_loctr_cycle()
     {
         resolve_dependant_default(target);
         dependencies_.erase(target);
+        last_dependencies_.erase(target);
         try_erase_source_statement(target);
     }
 
@@ -444,6 +555,10 @@ std::vector<post_stmt_ptr> symbol_dependency_tables::collect_postponed()
     postponed_stmts_.clear();
     dependency_source_stmts_.clear();
     dependencies_.clear();
+    last_dependencies_.clear();
+    symbol_waiters_.clear();
+    space_waiters_.clear();
+    ready_.clear();
 
     return res;
 }
@@ -55,6 +55,15 @@ class symbol_dependency_tables
     // list of statements containing dependencies that can not be checked yet
     std::unordered_set<post_stmt_ptr> postponed_stmts_;
 
+    // dependencies of waiting dependants as they were extracted the last time
+    std::unordered_map<dependant, std::vector<dependant>> last_dependencies_;
+    // reverse edges, dependants waiting for a symbol (its value or attributes) to be defined
+    std::unordered_map<id_index, std::unordered_set<dependant>> symbol_waiters_;
+    // reverse edges, dependants waiting for a space to be resolved
+    std::unordered_map<space_ptr, std::unordered_set<dependant>> space_waiters_;
+    // dependants whose dependencies may have been defined, they are checked by the next resolve
+    std::vector<dependant> ready_;
+
     ordinary_assembly_context& sym_ctx_;
 
     bool check_cycle(dependant target, std::vector<dependant> dependencies);
@@ -65,6 +74,15 @@ class symbol_dependency_tables
 
     std::vector<dependant> extract_dependencies(const resolvable* dependency_source);
     std::vector<dependant> extract_dependencies(const std::vector<const resolvable*>& dependency_sources);
+    // dependencies of the target, the extracted ones are reused while none of them is defined
+    std::vector<dependant> current_dependencies(const dependant& target, const resolvable* dependency_source);
+    bool is_undefined(const dependant& dep) const;
+
+    // registers reverse edges from the dependencies to the target
+    void wait_for(dependant target, std::vector<dependant> dependencies);
+    void wake_dependants(const dependant& defined);
+    void wake(std::unordered_set<dependant>& waiters);
+    void wake_resolved_spaces();
 
     void try_erase_source_statement(dependant index);
 
@@ -97,6 +115,9 @@ public:
     // method for creating more than one dependency assigned to one statement
     dependency_adder add_dependencies(post_stmt_ptr dependency_source_stmt);
 
+    // registers that the symbol has been created, its dependants are checked by the next add_defined
+    void add_defined_symbol(id_index symbol);
+
     // registers that some symbol has been defined
     // if resolver is present, location counter dependencies are checked as well (not just symbol deps)
     void add_defined(loctr_dependency_resolver* resolver = nullptr);
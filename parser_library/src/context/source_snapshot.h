@@ -97,6 +97,25 @@ struct source_snapshot
 
         return true;
     }
+
+    // returns true when the snapshot points to a statement that is processed before the statement of the other one,
+    // statements inside copy members are compared by their offsets when both snapshots are in the same invocation
+    bool precedes(const source_snapshot& oth) const
+    {
+        if (end_index != oth.end_index)
+            return end_index < oth.end_index;
+
+        for (size_t i = 0; i < copy_frames.size() && i < oth.copy_frames.size(); ++i)
+        {
+            if (copy_frames[i].copy_member != oth.copy_frames[i].copy_member)
+                return false;
+            if (copy_frames[i].statement_offset != oth.copy_frames[i].statement_offset)
+                return copy_frames[i].statement_offset < oth.copy_frames[i].statement_offset;
+        }
+
+        // the statement with the copy member invocation precedes the statements of the member
+        return copy_frames.size() < oth.copy_frames.size();
+    }
 };
 
 } // namespace hlasm_plugin::parser_library::context
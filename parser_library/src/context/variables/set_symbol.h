@@ -15,7 +15,10 @@
 #ifndef CONTEXT_SET_SYMBOL_H
 #define CONTEXT_SET_SYMBOL_H
 
+#include <deque>
 #include <map>
+#include <optional>
+#include <type_traits>
 #include <vector>
 
 #include "variable.h"
@@ -65,7 +68,50 @@ class set_symbol : public set_symbol_base
 
     // data holding this set_symbol
     // can be scalar or only array of scallars - no other nesting allowed
-    std::map<size_t, T> data;
+    // the value of a scalar is held inline
+    std::optional<T> scalar_data;
+    // values of an array at indices 0 .. dense_data.size() - 1, all of them are set
+    // std::vector<bool> does not hold addressable elements, so logical arrays use std::deque
+    std::conditional_t<std::is_same_v<T, bool>, std::deque<T>, std::vector<T>> dense_data;
+    // values of an array at the remaining indices, all of them are greater than dense_data.size()
+    std::map<size_t, T> sparse_data;
+
+    const T* find(size_t idx) const
+    {
+        if (is_scalar)
+            return scalar_data ? &*scalar_data : nullptr;
+
+        if (idx < dense_data.size())
+            return &dense_data[idx];
+
+        auto tmp = sparse_data.find(idx);
+        return tmp == sparse_data.end() ? nullptr : &tmp->second;
+    }
+
+    void assign(T value, size_t idx)
+    {
+        if (is_scalar)
+        {
+            scalar_data = std::move(value);
+            return;
+        }
+
+        if (idx < dense_data.size())
+            dense_data[idx] = std::move(value);
+        else if (idx == dense_data.size())
+        {
+            dense_data.push_back(std::move(value));
+            // the sparse values following the dense range are moved to it
+            auto it = sparse_data.begin();
+            while (it != sparse_data.end() && it->first == dense_data.size())
+            {
+                dense_data.push_back(std::move(it->second));
+                it = sparse_data.erase(it);
+            }
+        }
+        else
+            sparse_data.insert_or_assign(idx, std::move(value));
+    }
 
 public:
     set_symbol(id_index name, bool is_scalar, bool is_global)
@@ -79,10 +125,8 @@ public:
         if (is_scalar)
             return object_traits<T>::default_v();
 
-        auto tmp = data.find(idx);
-        if (tmp == data.end())
-            return object_traits<T>::default_v();
-        return tmp->second;
+        auto tmp = find(idx);
+        return tmp ? *tmp : object_traits<T>::default_v();
     }
 
     // gets value from scalar set symbol
@@ -91,57 +135,60 @@ public:
         if (!is_scalar)
             return object_traits<T>::default_v();
 
-        auto tmp = data.find(0);
-        if (tmp == data.end())
-            return object_traits<T>::default_v();
-        return tmp->second;
+        auto tmp = find(0);
+        return tmp ? *tmp : object_traits<T>::default_v();
     }
 
     // sets value to scalar set symbol
-    void set_value(T value) { data.insert_or_assign(0, std::move(value)); }
+    void set_value(T value) { assign(std::move(value), 0); }
 
     // sets value to non scalar set symbol
     // any index can be accessed
-    void set_value(T value, size_t idx)
-    {
-        if (is_scalar)
-            data.insert_or_assign(0, std::move(value));
-        else
-            data.insert_or_assign(idx, std::move(value));
-    }
+    void set_value(T value, size_t idx) { assign(std::move(value), is_scalar ? 0 : idx); }
 
     // N' attribute of the symbol
     virtual A_t number(std::vector<size_t>) const override
     {
-        return (A_t)(is_scalar || data.empty() ? 0 : data.rbegin()->first + 1);
+        if (is_scalar)
+            return 0;
+        return (A_t)(sparse_data.empty() ? dense_data.size() : sparse_data.rbegin()->first + 1);
     }
 
     // K' attribute of the symbol
     virtual A_t count(std::vector<size_t> offset) const override;
 
-    virtual size_t size() const override { return data.size(); };
+    virtual size_t size() const override
+    {
+        if (is_scalar)
+            return scalar_data ? 1 : 0;
+        return dense_data.size() + sparse_data.size();
+    }
 
     virtual std::vector<size_t> keys() const override
     {
         std::vector<size_t> keys;
-        keys.reserve(data.size());
-        for (auto& [key, value] : data)
+        if (is_scalar)
+        {
+            if (scalar_data)
+                keys.push_back(0);
+            return keys;
+        }
+
+        keys.reserve(size());
+        for (size_t i = 0; i < dense_data.size(); ++i)
+            keys.push_back(i);
+        for (auto& [key, value] : sparse_data)
             keys.push_back(key);
         return keys;
     }
 
 private:
-    const T* get_data(std::vector<size_t> offset) const
+    const T* get_data(const std::vector<size_t>& offset) const
     {
         if ((is_scalar && !offset.empty()) || (!is_scalar && offset.size() != 1))
             return nullptr;
 
-        auto tmp_offs = is_scalar ? 0 : offset.front() - 1;
-
-        if (data.find(tmp_offs) == data.end())
-            return nullptr;
-
-        return &data.at(tmp_offs);
+        return find(is_scalar ? 0 : offset.front() - 1);
     }
 };
 
@@ -149,7 +196,7 @@ private:
 template<>
 inline A_t set_symbol<A_t>::count(std::vector<size_t> offset) const
 {
-    auto tmp = get_data(std::move(offset));
+    auto tmp = get_data(offset);
     return tmp ? (A_t)std::to_string(*tmp).size() : (A_t)1;
 }
 
@@ -162,7 +209,7 @@ inline A_t set_symbol<B_t>::count(std::vector<size_t>) const
 template<>
 inline A_t set_symbol<C_t>::count(std::vector<size_t> offset) const
 {
-    auto tmp = get_data(std::move(offset));
+    auto tmp = get_data(offset);
     return tmp ? (A_t)tmp->size() : (A_t)0;
 }
 
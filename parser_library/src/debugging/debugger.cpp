@@ -195,30 +195,44 @@ const std::vector<scope>& debugger::scopes(frame_id_t frame_id)
 
 
     if (proc_stack_[frame_id].scope.is_in_macro())
-        for (auto it : proc_stack_[frame_id].scope.this_macro->named_params)
+        for (const auto& param : proc_stack_[frame_id].scope.this_macro->params)
         {
-            if (it.first == context::id_storage::empty_id)
+            if (param->id == context::id_storage::empty_id)
                 continue;
-            scope_vars.push_back(std::make_unique<macro_param_variable>(*it.second, std::vector<size_t> {}));
+            scope_vars.push_back(std::make_unique<macro_param_variable>(*param, std::vector<size_t> {}));
         }
 
-    for (auto it : proc_stack_[frame_id].scope.variables)
-    {
-        if (it.second->is_global)
-            globals.push_back(std::make_unique<set_symbol_variable>(*it.second));
+    auto add_set_symbol = [&globals, &scope_vars](const context::set_symbol_base& set_sym) {
+        if (set_sym.is_global)
+            globals.push_back(std::make_unique<set_symbol_variable>(set_sym));
         else
-            scope_vars.push_back(std::make_unique<set_symbol_variable>(*it.second));
-    }
+            scope_vars.push_back(std::make_unique<set_symbol_variable>(set_sym));
+    };
 
-    for (auto it : proc_stack_[frame_id].scope.system_variables)
-    {
-        if (it.second->is_global)
-            globals.push_back(std::make_unique<macro_param_variable>(*it.second, std::vector<size_t> {}));
+    auto add_system_variable = [&globals, &scope_vars](const context::macro_param_base& sys_var) {
+        if (sys_var.is_global)
+            globals.push_back(std::make_unique<macro_param_variable>(sys_var, std::vector<size_t> {}));
         else
-            scope_vars.push_back(std::make_unique<macro_param_variable>(*it.second, std::vector<size_t> {}));
-        // fetch all vars
+            scope_vars.push_back(std::make_unique<macro_param_variable>(sys_var, std::vector<size_t> {}));
+    };
+
+    // the frame of a macro invocation holds its params too, those are already shown
+    for (const auto& var : proc_stack_[frame_id].scope.frame())
+    {
+        if (!var)
+            continue;
+        if (auto set_sym = var->access_set_symbol_base())
+            add_set_symbol(*set_sym);
+        else if (proc_stack_[frame_id].scope.this_macro->find_param(var->id) != var.get())
+            add_system_variable(*var->access_macro_param_base());
     }
 
+    for (auto it : proc_stack_[frame_id].scope.variables)
+        add_set_symbol(*it.second);
+
+    for (auto it : proc_stack_[frame_id].scope.system_variables)
+        add_system_variable(*it.second);
+
     for (const auto& it : ctx_->ord_ctx.get_all_symbols())
         ordinary_symbols.push_back(std::make_unique<ordinary_symbol_variable>(it.second));
 
@@ -270,7 +284,9 @@ debugger::~debugger()
 void debugger::debug_start(processor_file_ptr open_code, parse_lib_provider* provider)
 {
     std::lock_guard<std::mutex> guard(variable_mtx_);
-    analyzer a(open_code->get_text(), open_code->get_file_name(), *provider, this);
+    // the analyzer does not copy the text and the file may change during the debugging
+    std::string text = open_code->get_text();
+    analyzer a(text, open_code->get_file_name(), *provider, this);
 
     ctx_ = &a.context();
 
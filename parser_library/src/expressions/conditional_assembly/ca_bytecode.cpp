@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "ca_bytecode.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+
+#include "ca_operator_binary.h"
+#include "ca_operator_unary.h"
+#include "expressions/evaluation_context.h"
+#include "terms/ca_constant.h"
+#include "terms/ca_expr_list.h"
+
+namespace hlasm_plugin::parser_library::expressions {
+
+namespace {
+
+// returns the expression whose value the expression passes through unchanged, nullptr if there is none
+const ca_expression* transparent_child(const ca_expression& expr)
+{
+    if (auto par = dynamic_cast<const ca_par_operator*>(&expr))
+        return par->expr.get();
+    if (auto list = dynamic_cast<const ca_expr_list*>(&expr); list && list->expr_list.size() == 1)
+        return list->expr_list.front().get();
+    return nullptr;
+}
+
+std::optional<ca_opcode> basic_binary_opcode(const ca_expression& expr)
+{
+    if (dynamic_cast<const ca_basic_binary_operator<ca_add>*>(&expr))
+        return ca_opcode::ADD;
+    if (dynamic_cast<const ca_basic_binary_operator<ca_sub>*>(&expr))
+        return ca_opcode::SUB;
+    if (dynamic_cast<const ca_basic_binary_operator<ca_mul>*>(&expr))
+        return ca_opcode::MUL;
+    if (dynamic_cast<const ca_basic_binary_operator<ca_div>*>(&expr))
+        return ca_opcode::DIV;
+    return std::nullopt;
+}
+
+std::optional<ca_opcode> function_binary_opcode(const ca_function_binary_operator& op)
+{
+    if (op.expr_kind == context::SET_t_enum::A_TYPE)
+    {
+        switch (op.function)
+        {
+            case ca_expr_ops::SLA:
+                return ca_opcode::SLA;
+            case ca_expr_ops::SLL:
+                return ca_opcode::SLL;
+            case ca_expr_ops::SRA:
+                return ca_opcode::SRA;
+            case ca_expr_ops::SRL:
+                return ca_opcode::SRL;
+            case ca_expr_ops::AND:
+                return ca_opcode::AND_A;
+            case ca_expr_ops::OR:
+                return ca_opcode::OR_A;
+            case ca_expr_ops::XOR:
+                return ca_opcode::XOR_A;
+            default:
+                return std::nullopt;
+        }
+    }
+    else if (op.expr_kind == context::SET_t_enum::B_TYPE)
+    {
+        // character comparisons are left to the expression tree
+        bool arithmetic_operands = op.left_expr->expr_kind == context::SET_t_enum::A_TYPE;
+        switch (op.function)
+        {
+            case ca_expr_ops::EQ:
+                return arithmetic_operands ? std::optional(ca_opcode::EQ) : std::nullopt;
+            case ca_expr_ops::NE:
+                return arithmetic_operands ? std::optional(ca_opcode::NE) : std::nullopt;
+            case ca_expr_ops::LE:
+                return arithmetic_operands ? std::optional(ca_opcode::LE) : std::nullopt;
+            case ca_expr_ops::LT:
+                return arithmetic_operands ? std::optional(ca_opcode::LT) : std::nullopt;
+            case ca_expr_ops::GE:
+                return arithmetic_operands ? std::optional(ca_opcode::GE) : std::nullopt;
+            case ca_expr_ops::GT:
+                return arithmetic_operands ? std::optional(ca_opcode::GT) : std::nullopt;
+            case ca_expr_ops::AND:
+                return ca_opcode::AND_B;
+            case ca_expr_ops::OR:
+                return ca_opcode::OR_B;
+            case ca_expr_ops::XOR:
+                return ca_opcode::XOR_B;
+            case ca_expr_ops::AND_NOT:
+                return ca_opcode::AND_NOT;
+            case ca_expr_ops::OR_NOT:
+                return ca_opcode::OR_NOT;
+            case ca_expr_ops::XOR_NOT:
+                return ca_opcode::XOR_NOT;
+            default:
+                return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+// returns the type of values the operation reads
+context::SET_t_enum operands_kind(ca_opcode opcode)
+{
+    switch (opcode)
+    {
+        case ca_opcode::NOT_B:
+        case ca_opcode::AND_B:
+        case ca_opcode::OR_B:
+        case ca_opcode::XOR_B:
+        case ca_opcode::AND_NOT:
+        case ca_opcode::OR_NOT:
+        case ca_opcode::XOR_NOT:
+            return context::SET_t_enum::B_TYPE;
+        default:
+            return context::SET_t_enum::A_TYPE;
+    }
+}
+
+// returns the type of the value the operation yields
+context::SET_t_enum result_kind(ca_opcode opcode)
+{
+    switch (opcode)
+    {
+        case ca_opcode::EQ:
+        case ca_opcode::NE:
+        case ca_opcode::LE:
+        case ca_opcode::LT:
+        case ca_opcode::GE:
+        case ca_opcode::GT:
+            return context::SET_t_enum::B_TYPE;
+        default:
+            return operands_kind(opcode);
+    }
+}
+
+// the operation of the expression that is executed on the stack
+// the plus operator has none, it only passes the arithmetic value of its operand
+struct stack_operation
+{
+    std::optional<ca_opcode> opcode;
+    context::SET_t_enum result_kind;
+};
+
+std::optional<stack_operation> get_stack_operation(const ca_expression& expr)
+{
+    if (dynamic_cast<const ca_constant*>(&expr))
+        return stack_operation { ca_opcode::PUSH_CONST, context::SET_t_enum::A_TYPE };
+
+    if (auto opcode = basic_binary_opcode(expr))
+        return stack_operation { opcode, context::SET_t_enum::A_TYPE };
+
+    if (auto op = dynamic_cast<const ca_function_binary_operator*>(&expr))
+    {
+        if (auto opcode = function_binary_opcode(*op))
+            return stack_operation { opcode, result_kind(*opcode) };
+        return std::nullopt;
+    }
+
+    if (dynamic_cast<const ca_plus_operator*>(&expr))
+        return stack_operation { std::nullopt, context::SET_t_enum::A_TYPE };
+    if (dynamic_cast<const ca_minus_operator*>(&expr))
+        return stack_operation { ca_opcode::NEG, context::SET_t_enum::A_TYPE };
+
+    if (auto op = dynamic_cast<const ca_function_unary_operator*>(&expr); op && op->function == ca_expr_ops::NOT)
+    {
+        if (op->expr_kind == context::SET_t_enum::A_TYPE)
+            return stack_operation { ca_opcode::NOT_A, context::SET_t_enum::A_TYPE };
+        if (op->expr_kind == context::SET_t_enum::B_TYPE)
+            return stack_operation { ca_opcode::NOT_B, context::SET_t_enum::B_TYPE };
+    }
+
+    return std::nullopt;
+}
+
+// finds the value kind of the expression when it can be evaluated on the stack
+std::optional<context::SET_t_enum> stack_result_kind(const ca_expression& expr)
+{
+    if (auto child = transparent_child(expr))
+        return stack_result_kind(*child);
+    if (auto op = get_stack_operation(expr))
+        return op->result_kind;
+    return std::nullopt;
+}
+
+// the stack holds arithmetic values, logical values are stored as 0 and 1
+// the representation matches SET_t, whose logical value of an arithmetic value is its comparison with 0
+context::A_t from_bool(bool value) { return value ? 1 : 0; }
+
+// the arithmetic is done on unsigned values to wrap around on overflow
+context::A_t wrap(std::uint32_t value) { return (context::A_t)value; }
+
+} // namespace
+
+ca_bytecode::ca_bytecode(const ca_expression& expr, context::SET_t_enum result_kind)
+    : expr_(expr)
+    , result_kind_(result_kind)
+{}
+
+std::unique_ptr<const ca_bytecode> ca_bytecode::compile(const ca_expression& expr)
+{
+    const ca_expression* root = &expr;
+    while (auto child = transparent_child(*root))
+        root = child;
+
+    auto kind = stack_result_kind(*root);
+    if (!kind || dynamic_cast<const ca_constant*>(root))
+        return nullptr;
+
+    std::unique_ptr<ca_bytecode> bytecode(new ca_bytecode(expr, *kind));
+    bytecode->compile_node(*root, *kind, 0);
+    return bytecode;
+}
+
+void ca_bytecode::emit(ca_opcode opcode, size_t depth, context::A_t value, const ca_expression* expr)
+{
+    program_.push_back({ opcode, value, expr });
+    max_depth_ = std::max(max_depth_, depth + 1);
+}
+
+void ca_bytecode::compile_node(const ca_expression& expr, context::SET_t_enum wanted, size_t depth)
+{
+    if (auto child = transparent_child(expr))
+    {
+        compile_node(*child, wanted, depth);
+        return;
+    }
+
+    auto op = get_stack_operation(expr);
+    if (!op)
+    {
+        emit(wanted == context::SET_t_enum::B_TYPE ? ca_opcode::PUSH_TERM_B : ca_opcode::PUSH_TERM_A, depth, 0, &expr);
+        return;
+    }
+
+    if (auto constant = dynamic_cast<const ca_constant*>(&expr))
+    {
+        emit(ca_opcode::PUSH_CONST, depth, constant->value);
+        return;
+    }
+
+    if (auto unary = dynamic_cast<const ca_unary_operator*>(&expr))
+    {
+        if (!op->opcode)
+        {
+            compile_node(*unary->expr, context::SET_t_enum::A_TYPE, depth);
+            return;
+        }
+        compile_node(*unary->expr, operands_kind(*op->opcode), depth);
+        emit(*op->opcode, depth, 0, &expr);
+        return;
+    }
+
+    auto binary = dynamic_cast<const ca_binary_operator*>(&expr);
+    assert(binary && op->opcode);
+    compile_node(*binary->left_expr, operands_kind(*op->opcode), depth);
+    compile_node(*binary->right_expr, operands_kind(*op->opcode), depth + 1);
+    emit(*op->opcode, depth, 0, &expr);
+}
+
+context::SET_t ca_bytecode::run(const evaluation_context& eval_ctx) const
+{
+    // most expressions fit in the small stack, so no allocation is needed
+    constexpr size_t small_stack_size = 16;
+    context::A_t small_stack[small_stack_size];
+    std::vector<context::A_t> large_stack;
+    context::A_t* stack = small_stack;
+    if (max_depth_ > small_stack_size)
+    {
+        large_stack.resize(max_depth_);
+        stack = large_stack.data();
+    }
+
+    size_t top = 0;
+    for (const auto& instr : program_)
+    {
+        switch (instr.opcode)
+        {
+            case ca_opcode::PUSH_CONST:
+                stack[top++] = instr.value;
+                continue;
+            case ca_opcode::PUSH_TERM_A:
+                stack[top++] = instr.expr->evaluate(eval_ctx).access_a();
+                continue;
+            case ca_opcode::PUSH_TERM_B:
+                stack[top++] = from_bool(instr.expr->evaluate(eval_ctx).access_b());
+                continue;
+            case ca_opcode::NEG:
+                stack[top - 1] = wrap(0U - (std::uint32_t)stack[top - 1]);
+                continue;
+            case ca_opcode::NOT_A:
+                stack[top - 1] = ~stack[top - 1];
+                continue;
+            case ca_opcode::NOT_B:
+                stack[top - 1] = from_bool(stack[top - 1] == 0);
+                continue;
+            default:
+                break;
+        }
+
+        auto rhs = stack[--top];
+        auto& lhs = stack[top - 1];
+        switch (instr.opcode)
+        {
+            case ca_opcode::ADD:
+                lhs = overflow_transform((std::int64_t)lhs + (std::int64_t)rhs, instr.expr->expr_range, eval_ctx);
+                break;
+            case ca_opcode::SUB:
+                lhs = overflow_transform((std::int64_t)lhs - (std::int64_t)rhs, instr.expr->expr_range, eval_ctx);
+                break;
+            case ca_opcode::MUL:
+                lhs = overflow_transform((std::int64_t)lhs * (std::int64_t)rhs, instr.expr->expr_range, eval_ctx);
+                break;
+            case ca_opcode::DIV:
+                lhs = rhs == 0
+                    ? 0
+                    : overflow_transform((std::int64_t)lhs / (std::int64_t)rhs, instr.expr->expr_range, eval_ctx);
+                break;
+            case ca_opcode::AND_A:
+                lhs &= rhs;
+                break;
+            case ca_opcode::OR_A:
+                lhs |= rhs;
+                break;
+            case ca_opcode::XOR_A:
+                lhs ^= rhs;
+                break;
+            case ca_opcode::SLA:
+                lhs = shift_operands(lhs, rhs, ca_expr_ops::SLA);
+                break;
+            case ca_opcode::SLL:
+                lhs = shift_operands(lhs, rhs, ca_expr_ops::SLL);
+                break;
+            case ca_opcode::SRA:
+                lhs = shift_operands(lhs, rhs, ca_expr_ops::SRA);
+                break;
+            case ca_opcode::SRL:
+                lhs = shift_operands(lhs, rhs, ca_expr_ops::SRL);
+                break;
+            // the comparison is done on the difference of the values, the same way as by the expression tree
+            case ca_opcode::EQ:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) == 0);
+                break;
+            case ca_opcode::NE:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) != 0);
+                break;
+            case ca_opcode::LE:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) <= 0);
+                break;
+            case ca_opcode::LT:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) < 0);
+                break;
+            case ca_opcode::GE:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) >= 0);
+                break;
+            case ca_opcode::GT:
+                lhs = from_bool(wrap((std::uint32_t)lhs - (std::uint32_t)rhs) > 0);
+                break;
+            case ca_opcode::AND_B:
+                lhs = from_bool(lhs != 0 && rhs != 0);
+                break;
+            case ca_opcode::OR_B:
+                lhs = from_bool(lhs != 0 || rhs != 0);
+                break;
+            case ca_opcode::XOR_B:
+                lhs = from_bool((lhs != 0) != (rhs != 0));
+                break;
+            case ca_opcode::AND_NOT:
+                lhs = from_bool(lhs != 0 && rhs == 0);
+                break;
+            case ca_opcode::OR_NOT:
+                lhs = from_bool(lhs != 0 || rhs == 0);
+                break;
+            case ca_opcode::XOR_NOT:
+                lhs = from_bool((lhs != 0) != (rhs == 0));
+                break;
+            default:
+                assert(false);
+                break;
+        }
+    }
+
+    assert(top == 1);
+    if (result_kind_ == context::SET_t_enum::B_TYPE)
+        return stack[0] != 0;
+    return stack[0];
+}
+
+} // namespace hlasm_plugin::parser_library::expressions
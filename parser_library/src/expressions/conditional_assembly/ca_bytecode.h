@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_CA_BYTECODE_H
+#define HLASMPLUGIN_PARSERLIBRARY_CA_BYTECODE_H
+
+#include <memory>
+#include <vector>
+
+#include "ca_expression.h"
+
+namespace hlasm_plugin::parser_library::expressions {
+
+enum class ca_opcode : unsigned char
+{
+    // pushes the constant value
+    PUSH_CONST,
+    // evaluates the subtree and pushes its arithmetic value
+    PUSH_TERM_A,
+    // evaluates the subtree and pushes its logical value
+    PUSH_TERM_B,
+
+    // arithmetic operations
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    NEG,
+    NOT_A,
+    AND_A,
+    OR_A,
+    XOR_A,
+    SLA,
+    SLL,
+    SRA,
+    SRL,
+
+    // comparison of arithmetic values
+    EQ,
+    NE,
+    LE,
+    LT,
+    GE,
+    GT,
+
+    // logical operations
+    NOT_B,
+    AND_B,
+    OR_B,
+    XOR_B,
+    AND_NOT,
+    OR_NOT,
+    XOR_NOT,
+};
+
+struct ca_instruction
+{
+    ca_opcode opcode;
+    // value of PUSH_CONST
+    context::A_t value;
+    // subtree of PUSH_TERM, expression of the operation that reports overflow diagnostics
+    const ca_expression* expr;
+};
+
+// conditional assembly expression compiled into a postfix program for a stack machine
+// arithmetic and logical operators are executed directly on the stack,
+// other terms (variable symbols, functions, attributes, strings) are evaluated by their subtrees
+// the program refers to the expression tree, so it must not outlive it
+class ca_bytecode
+{
+    const ca_expression& expr_;
+    std::vector<ca_instruction> program_;
+    size_t max_depth_ = 0;
+    context::SET_t_enum result_kind_;
+
+    ca_bytecode(const ca_expression& expr, context::SET_t_enum result_kind);
+
+    // appends the program evaluating the expression, wanted is the type its value is read as
+    void compile_node(const ca_expression& expr, context::SET_t_enum wanted, size_t depth);
+    void emit(ca_opcode opcode, size_t depth, context::A_t value = 0, const ca_expression* expr = nullptr);
+
+public:
+    // compiles the resolved arithmetic or logical expression
+    // returns nullptr when there is nothing to gain, i.e. the expression is a single term
+    static std::unique_ptr<const ca_bytecode> compile(const ca_expression& expr);
+
+    // runs the program, yields the same value as ca_expression::evaluate
+    context::SET_t run(const evaluation_context& eval_ctx) const;
+
+    template<typename T>
+    T evaluate(const evaluation_context& eval_ctx) const
+    {
+        return expr_.convert_to<T>(run(eval_ctx), eval_ctx);
+    }
+
+    const std::vector<ca_instruction>& program() const { return program_; }
+};
+
+} // namespace hlasm_plugin::parser_library::expressions
+
+#endif
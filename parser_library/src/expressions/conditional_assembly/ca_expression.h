@@ -48,7 +48,14 @@ public:
     virtual bool is_character_expression() const = 0;
 
     template<typename T>
-    T evaluate(const evaluation_context& eval_ctx) const;
+    T evaluate(const evaluation_context& eval_ctx) const
+    {
+        return convert_to<T>(evaluate(eval_ctx), eval_ctx);
+    }
+
+    // converts the value of the expression to the requested type
+    template<typename T>
+    T convert_to(context::SET_t value, const evaluation_context& eval_ctx) const;
 
     virtual context::SET_t evaluate(const evaluation_context& eval_ctx) const = 0;
 
@@ -61,12 +68,10 @@ protected:
 
 
 template<typename T>
-inline T ca_expression::evaluate(const evaluation_context& eval_ctx) const
+inline T ca_expression::convert_to(context::SET_t value, const evaluation_context& eval_ctx) const
 {
     static_assert(context::object_traits<T>::type_enum != context::SET_t_enum::UNDEF_TYPE);
-    auto ret = evaluate(eval_ctx);
-
-    ret = convert_return_types(std::move(ret), context::object_traits<T>::type_enum, eval_ctx);
+    auto ret = convert_return_types(std::move(value), context::object_traits<T>::type_enum, eval_ctx);
 
     if constexpr (context::object_traits<T>::type_enum == context::SET_t_enum::A_TYPE)
         return ret.access_a();
@@ -15,6 +15,8 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_CA_OPERATOR_BINARY_H
 #define HLASMPLUGIN_PARSERLIBRARY_CA_OPERATOR_BINARY_H
 
+#include <cstdint>
+
 #include "ca_expr_policy.h"
 #include "ca_expression.h"
 
@@ -83,6 +85,12 @@ private:
     bool is_relational() const;
 };
 
+// shifts the arithmetic value as the SLA, SLL, SRA and SRL operators do
+context::A_t shift_operands(context::A_t lhs, context::A_t rhs, ca_expr_ops shift);
+
+// reports overflow of the result of an arithmetic operation
+context::A_t overflow_transform(std::int64_t val, range expr_range, const evaluation_context& eval_ctx);
+
 struct ca_add
 {
     static constexpr context::SET_t_enum type = context::SET_t_enum::A_TYPE;
@@ -51,6 +51,8 @@ void mach_expr_constant::fill_location_counter(context::address) {}
 
 const mach_expression* mach_expr_constant::leftmost_term() const { return this; }
 
+mach_expr_ptr mach_expr_constant::clone() const { return std::make_unique<mach_expr_constant>(*this); }
+
 
 
 //***********  mach_expr_symbol ************
@@ -83,6 +85,8 @@ mach_expr_constant::value_t mach_expr_symbol::evaluate(mach_evaluate_info info)
 }
 void mach_expr_symbol::fill_location_counter(context::address) {}
 const mach_expression* mach_expr_symbol::leftmost_term() const { return this; }
+
+mach_expr_ptr mach_expr_symbol::clone() const { return std::make_unique<mach_expr_symbol>(*this); }
 //***********  mach_expr_self_def ************
 mach_expr_self_def::mach_expr_self_def(std::string option, std::string value, range rng)
     : mach_expression(rng)
@@ -102,6 +106,8 @@ void mach_expr_self_def::fill_location_counter(context::address) {}
 
 const mach_expression* mach_expr_self_def::leftmost_term() const { return this; }
 
+mach_expr_ptr mach_expr_self_def::clone() const { return std::make_unique<mach_expr_self_def>(*this); }
+
 mach_expr_location_counter::mach_expr_location_counter(range rng)
     : mach_expression(rng)
 {}
@@ -126,6 +132,8 @@ void mach_expr_location_counter::fill_location_counter(context::address addr) {
 
 const mach_expression* mach_expr_location_counter::leftmost_term() const { return this; }
 
+mach_expr_ptr mach_expr_location_counter::clone() const { return std::make_unique<mach_expr_location_counter>(*this); }
+
 mach_expr_default::mach_expr_default(range rng)
     : mach_expression(rng)
 {}
@@ -141,6 +149,8 @@ void mach_expr_default::fill_location_counter(context::address) {}
 
 const mach_expression* mach_expr_default::leftmost_term() const { return this; }
 
+mach_expr_ptr mach_expr_default::clone() const { return std::make_unique<mach_expr_default>(*this); }
+
 void mach_expr_default::collect_diags() const {}
 
 mach_expr_data_attr::mach_expr_data_attr(context::id_index value, context::data_attr_kind attribute, range rng)
@@ -186,3 +196,5 @@ mach_expression::value_t mach_expr_data_attr::evaluate(mach_evaluate_info info)
 void mach_expr_data_attr::fill_location_counter(context::address) {}
 
 const mach_expression* mach_expr_data_attr::leftmost_term() const { return this; }
+
+mach_expr_ptr mach_expr_data_attr::clone() const { return std::make_unique<mach_expr_data_attr>(*this); }
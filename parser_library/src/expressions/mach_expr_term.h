@@ -37,6 +37,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     void collect_diags() const override {}
 };
 
@@ -57,6 +59,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     void collect_diags() const override {}
 };
 
@@ -79,6 +83,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     void collect_diags() const override {}
 };
 
@@ -98,6 +104,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     void collect_diags() const override {}
 };
 
@@ -117,6 +125,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     void collect_diags() const override {}
 };
 
@@ -135,6 +145,8 @@ public:
 
     virtual const mach_expression* leftmost_term() const override;
 
+    mach_expr_ptr clone() const override;
+
     virtual void collect_diags() const override;
 };
 
@@ -50,6 +50,9 @@ public:
 
     virtual const mach_expression* leftmost_term() const = 0;
 
+    // Creates a deep copy of the expression including its diagnostics.
+    virtual mach_expr_ptr clone() const = 0;
+
     range get_range() const;
     virtual ~mach_expression() {}
 
@@ -52,6 +52,13 @@ public:
 
     const mach_expression* leftmost_term() const override { return left_->leftmost_term(); }
 
+    mach_expr_ptr clone() const override
+    {
+        auto ret = std::make_unique<mach_expr_binary<T>>(left_->clone(), right_->clone(), get_range());
+        ret->diags() = diags();
+        return ret;
+    }
+
     void collect_diags() const override
     {
         collect_diags_from_child(*left_);
@@ -86,6 +93,13 @@ public:
 
     virtual const mach_expression* leftmost_term() const override { return child_->leftmost_term(); }
 
+    mach_expr_ptr clone() const override
+    {
+        auto ret = std::make_unique<mach_expr_unary<T>>(child_->clone(), get_range());
+        ret->diags() = diags();
+        return ret;
+    }
+
     void collect_diags() const override { collect_diags_from_child(*child_); }
 };
 
@@ -14,92 +14,179 @@
 
 #include "input_source.h"
 
-#include <exception>
+#include <algorithm>
+#include <cassert>
 
 namespace hlasm_plugin::parser_library::lexing {
 
+namespace {
+bool is_continuation_byte(unsigned char c) { return (c & 0xC0) == 0x80; }
+} // namespace
 
 input_source::input_source(const std::string& input)
-    : ANTLRInputStream(input)
+    : owned_(input)
+    , data_(owned_)
 {}
 
-void input_source::append(const UTF32String& str) { _data.append(str); }
+input_source::input_source(std::string_view input, non_owning_t)
+    : data_(input)
+{}
 
 void input_source::append(const std::string& str)
 {
-    p = _data.size();
-    _data.append(antlrcpp::utf8_to_utf32(str.data(), str.data() + str.size()));
+    // text that is not owned is copied on the first modification
+    if (data_.data() != owned_.data())
+        owned_.assign(data_);
+    owned_.append(str);
+    data_ = owned_;
 }
 
-void input_source::reset(const std::string& str) { load(str); }
+void input_source::reset(const std::string& str)
+{
+    owned_ = str;
+    data_ = owned_;
+    p_ = 0;
+}
 
-std::string input_source::getText(const antlr4::misc::Interval& interval)
+void input_source::rewind_input(size_t position)
+{
+    assert(position <= data_.size());
+    // the position must point to the beginning of a character
+    while (position > 0 && position < data_.size() && is_continuation_byte(data_[position]))
+        --position;
+    p_ = position;
+}
+
+void input_source::consume()
+{
+    if (p_ >= data_.size())
+        throw antlr4::IllegalStateException("cannot consume EOF");
+    p_ += char_length(p_);
+}
+
+size_t input_source::LA(ssize_t i)
 {
-    std::string n;
-    for (auto i = interval.a; i <= interval.b; ++i)
+    if (i == 0)
+        return 0; // undefined
+
+    size_t pos = p_;
+    if (i < 0)
     {
-        uint32_t ch = _data[i];
-        constexpr unsigned int last6 = 0x3F;
-        constexpr unsigned int last5 = 0x1F;
-        constexpr unsigned int last4 = 0x0F;
-        constexpr unsigned int last3 = 0x07;
-        if (ch <= 0x007F) // U+0000 - U+007F
-            n.insert(n.end(), (char)ch);
-        else if (ch <= 0x7FF) // U+0080 - U+07FF
+        for (; i < 0; ++i)
         {
-            char utf8[2];
-            utf8[1] = '\x80'; // 10xxxxxx
-            utf8[1] += ch & last6;
+            if (pos == 0)
+                return EOF;
+            do
+                --pos;
+            while (pos > 0 && is_continuation_byte(data_[pos]));
+        }
+        return decode(pos);
+    }
 
-            ch = ch >> 6;
-            utf8[0] = '\xc0'; // 110xxxxx
-            utf8[0] += ch & last5;
+    for (; i > 1 && pos < data_.size(); --i)
+        pos += char_length(pos);
 
-            n.append(utf8, 2);
-        }
-        else if (ch <= 0xFFFF) // U+0800 - U+FFFF
-        {
-            char utf8[3];
-            // third
-            utf8[2] = '\x80';
-            utf8[2] += ch & last6;
+    if (pos >= data_.size())
+        return EOF;
+    return decode(pos);
+}
 
-            ch = ch >> 6;
-            // second
-            utf8[1] = '\x80';
-            utf8[1] += ch & last6;
+ssize_t input_source::mark() { return -1; }
 
-            ch = ch >> 6;
-            utf8[0] = '\xe0';
-            utf8[0] += ch & last4;
+void input_source::release(ssize_t) {}
 
-            n.append(utf8, 3);
-        }
-        else if (ch <= 0x10FFFF) // U+10000 - U+10FFFF
-        {
-            char utf8[4];
-            for (int j = 3; j > 0; --j)
-            {
-                utf8[j] = '\x80';
-                utf8[j] += ch & last6;
-                ch = ch >> 6;
-            }
-
-            utf8[0] = '\xf0'; // 11110xxx
-            utf8[0] += ch & last3;
-
-            n.append(utf8, 4);
-        }
-        else
-            throw std::runtime_error("not valid unicode character");
+size_t input_source::index() { return p_; }
+
+void input_source::seek(size_t index) { rewind_input(std::min(index, data_.size())); }
+
+size_t input_source::size() { return data_.size(); }
+
+std::string input_source::getSourceName() const { return antlr4::IntStream::UNKNOWN_SOURCE_NAME; }
+
+std::string input_source::getText(const antlr4::misc::Interval& interval)
+{
+    if (interval.a < 0 || interval.b < 0)
+        return "";
+
+    size_t start = (size_t)interval.a;
+    size_t stop = std::min((size_t)interval.b, data_.size() - 1);
+    if (start >= data_.size() || stop < start)
+        return "";
+
+    return std::string(data_.substr(start, stop - start + 1));
+}
+
+std::string input_source::toString() const { return std::string(data_); }
+
+std::string_view input_source::text() const { return data_; }
+
+std::string_view input_source::remaining_text() const { return data_.substr(p_); }
+
+size_t input_source::char_count(size_t start, size_t stop) const
+{
+    stop = std::min(stop + 1, data_.size());
+    if (start >= stop)
+        return 0;
+    return std::count_if(
+        data_.begin() + start, data_.begin() + stop, [](unsigned char c) { return !is_continuation_byte(c); });
+}
+
+size_t input_source::utf16_column(utf16_anchor anchor, size_t offset) const
+{
+    offset = std::min(offset, data_.size());
+    if (anchor.offset >= offset)
+        return anchor.column;
+
+    // characters of 4 bytes are encoded by two UTF-16 code units, continuation bytes are not counted
+    size_t column = anchor.column;
+    for (auto it = data_.begin() + anchor.offset; it != data_.begin() + offset; ++it)
+    {
+        unsigned char c = *it;
+        if (c < 0x80)
+            ++column;
+        else if (!is_continuation_byte(c))
+            column += (c & 0xF8) == 0xF0 ? 2 : 1;
     }
-    return n;
+    return column;
 }
 
-void input_source::rewind_input(size_t position)
+size_t input_source::char_length(size_t offset) const
 {
-    assert(position < _data.length());
-    p = position;
+    unsigned char c = data_[offset];
+    size_t length = 1;
+    if ((c & 0xE0) == 0xC0)
+        length = 2;
+    else if ((c & 0xF0) == 0xE0)
+        length = 3;
+    else if ((c & 0xF8) == 0xF0)
+        length = 4;
+
+    // invalid sequences are read byte by byte
+    for (size_t i = 1; i < length; ++i)
+        if (offset + i >= data_.size() || !is_continuation_byte(data_[offset + i]))
+            return 1;
+    return length;
+}
+
+char32_t input_source::decode(size_t offset) const
+{
+    unsigned char c = data_[offset];
+    if (c < 0x80)
+        return c;
+
+    switch (char_length(offset))
+    {
+        case 2:
+            return (char32_t)(c & 0x1F) << 6 | (data_[offset + 1] & 0x3F);
+        case 3:
+            return (char32_t)(c & 0x0F) << 12 | (char32_t)(data_[offset + 1] & 0x3F) << 6
+                | (data_[offset + 2] & 0x3F);
+        case 4:
+            return (char32_t)(c & 0x07) << 18 | (char32_t)(data_[offset + 1] & 0x3F) << 12
+                | (char32_t)(data_[offset + 2] & 0x3F) << 6 | (data_[offset + 3] & 0x3F);
+        default:
+            return c;
+    }
 }
 
-} // namespace hlasm_plugin::parser_library::lexing
\ No newline at end of file
+} // namespace hlasm_plugin::parser_library::lexing
@@ -15,6 +15,9 @@
 #ifndef HLASMPLUGIN_PARSER_HLASMINPUTSOURCE_H
 #define HLASMPLUGIN_PARSER_HLASMINPUTSOURCE_H
 
+#include <string>
+#include <string_view>
+
 #include "antlr4-runtime.h"
 
 #include "parser_library_export.h"
@@ -22,18 +25,33 @@
 namespace hlasm_plugin {
 namespace parser_library {
 namespace lexing {
+
 /*
-        custom ANTLRInputStream
+        CharStream working directly on UTF-8 encoded text
+        indices of the stream are byte offsets to the text, characters are decoded when they are read
         supports input rewinding, appending and resetting
 */
-class input_source : public antlr4::ANTLRInputStream
+class input_source : public antlr4::CharStream
 {
 public:
-    input_source(const std::string& input);
+    struct non_owning_t
+    {};
+    static constexpr non_owning_t non_owning {};
+
+    // offset of a character with known UTF-16 column
+    struct utf16_anchor
+    {
+        size_t offset = 0;
+        size_t column = 0;
+    };
+
+    // the stream works on its own copy of the text
+    explicit input_source(const std::string& input);
+    // the stream reads the text in place, the text must outlive the stream (or its first append or reset)
+    input_source(std::string_view input, non_owning_t);
 
-    void append(const UTF32String& str);
+    // appends the text, the current position is kept
     void append(const std::string& str);
-    using antlr4::ANTLRInputStream::reset;
     void reset(const std::string& str);
     void rewind_input(size_t index);
 
@@ -42,9 +60,37 @@ public:
     input_source& operator=(input_source&&) = delete;
     input_source(input_source&&) = delete;
 
-    virtual std::string getText(const antlr4::misc::Interval& interval) override;
+    void consume() override;
+    size_t LA(ssize_t i) override;
+    ssize_t mark() override;
+    void release(ssize_t marker) override;
+    size_t index() override;
+    void seek(size_t index) override;
+    size_t size() override;
+    std::string getSourceName() const override;
+    std::string getText(const antlr4::misc::Interval& interval) override;
+    std::string toString() const override;
+
+    // whole text of the stream
+    std::string_view text() const;
+    // text that has not been consumed yet
+    std::string_view remaining_text() const;
+    // number of characters encoded in the bytes [start, stop]
+    size_t char_count(size_t start, size_t stop) const;
+    // UTF-16 column of the character at the offset, the anchor must be on the same line before the offset
+    size_t utf16_column(utf16_anchor anchor, size_t offset) const;
 
     virtual ~input_source() = default;
+
+private:
+    // storage of the text when it is owned or was modified
+    std::string owned_;
+    std::string_view data_;
+    size_t p_ = 0;
+
+    // length of UTF-8 sequence that starts at the offset
+    size_t char_length(size_t offset) const;
+    char32_t decode(size_t offset) const;
 };
 } // namespace lexing
 } // namespace parser_library
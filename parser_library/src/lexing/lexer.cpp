@@ -28,19 +28,12 @@ using namespace parser_library;
 using namespace lexing;
 
 
-/* UTF8 <-> UTF32 */
-#ifdef __GNUG__
-thread_local std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
-#elif _MSC_VER
-thread_local std::wstring_convert<std::codecvt_utf8<int32_t>, int32_t> converter;
-#endif
-
 lexer::lexer(input_source* input, semantics::lsp_info_processor* lsp_proc, performance_metrics* metrics)
     : input_(input)
     , lsp_proc_(lsp_proc)
     , metrics_(metrics)
 {
-    factory_ = std::make_unique<token_factory>();
+    factory_ = std::make_unique<token_factory>(metrics);
     // create empty ainsert buffer
     ainsert_stream_ = make_unique<input_source>("");
 
@@ -69,7 +62,7 @@ void lexer::rewind_input(stream_position pos)
     file_input_state_.char_position = pos.offset;
     file_input_state_.line = pos.line;
     file_input_state_.char_position_in_line = 0;
-    file_input_state_.char_position_in_line_utf16 = 0;
+    file_input_state_.utf16 = { pos.offset, 0 };
 
     if (pos.line == 0)
         last_lln_end_pos_ = { static_cast<size_t>(-1), static_cast<size_t>(-1) };
@@ -83,9 +76,14 @@ void lexer::rewind_input(stream_position pos)
 
 bool lexer::is_last_line() const
 {
-    for (size_t i = 1; input_->LA(i) != antlr4::CharStream::EOF && i < 100; i++)
+    // new line characters are never part of multi-byte sequences, so the bytes can be checked directly
+    auto rest = input_->remaining_text();
+    size_t chars = 0;
+    for (unsigned char c : rest)
     {
-        if (input_->LA(i) == '\n' || input_->LA(i) == '\r')
+        if ((c & 0xC0) != 0x80 && ++chars >= 100)
+            break;
+        if (c == '\n' || c == '\r')
             return false;
     }
     return true;
@@ -102,7 +100,7 @@ void lexer::set_file_offset(position file_offset)
 {
     input_state_->line = (size_t)file_offset.line;
     input_state_->char_position_in_line = (size_t)file_offset.column;
-    input_state_->char_position_in_line_utf16 = (size_t)file_offset.column;
+    input_state_->utf16 = { input_state_->char_position, (size_t)file_offset.column };
 }
 
 void lexer::reset()
@@ -110,14 +108,18 @@ void lexer::reset()
     token_queue_ = {};
     last_token_id_ = 0;
     input_state_->char_position = 0;
+    input_state_->utf16.offset = 0;
     file_input_state_.c = static_cast<char_t>(input_->LA(1));
     eof_generated_ = false;
+    lines_.reset();
+    current_line_ = 0;
 }
 
 void lexer::append()
 {
     file_input_state_.c = static_cast<char_t>(input_->LA(1));
     eof_generated_ = false;
+    lines_.reset();
 }
 
 
@@ -184,34 +186,31 @@ void lexer::create_token(size_t ttype, size_t channel = Channels::DEFAULT_CHANNE
         token_start_state_.line,
         token_start_state_.char_position_in_line,
         last_token_id_ - 1,
-        token_start_state_.char_position_in_line_utf16,
-        input_state_->char_position_in_line_utf16));
-
-    auto stop_position_in_line = (last_char_utf16_long_) ? input_state_->char_position_in_line_utf16 - 1
-                                                         : input_state_->char_position_in_line_utf16;
+        token_start_state_.utf16,
+        input_state_->utf16));
 
     if (lsp_proc_)
         switch (ttype)
         {
             case CONTINUATION:
                 lsp_proc_->add_hl_symbol(
-                    token_info(range(position(token_start_state_.line, token_start_state_.char_position_in_line_utf16),
-                                   position(input_state_->line, stop_position_in_line)),
+                    token_info(range(position(token_start_state_.line, token_start_state_.utf16_column()),
+                                   position(input_state_->line, input_state_->utf16_column())),
                         semantics::hl_scopes::continuation));
                 break;
             case IGNORED: {
-                auto line_pos =
-                    (token_start_state_.line != input_state_->line) ? last_line_pos_ : stop_position_in_line;
+                auto line_pos = (token_start_state_.line != input_state_->line) ? last_line_pos_
+                                                                                : input_state_->utf16_column();
                 lsp_proc_->add_hl_symbol(
-                    token_info(range(position(token_start_state_.line, token_start_state_.char_position_in_line_utf16),
+                    token_info(range(position(token_start_state_.line, token_start_state_.utf16_column()),
                                    position(token_start_state_.line, line_pos)),
                         semantics::hl_scopes::ignored));
             }
             break;
             case COMMENT:
                 lsp_proc_->add_hl_symbol(
-                    token_info(range(position(token_start_state_.line, token_start_state_.char_position_in_line_utf16),
-                                   position(input_state_->line, stop_position_in_line)),
+                    token_info(range(position(token_start_state_.line, token_start_state_.utf16_column()),
+                                   position(input_state_->line, input_state_->utf16_column())),
                         semantics::hl_scopes::comment));
                 break;
         }
@@ -219,37 +218,24 @@ void lexer::create_token(size_t ttype, size_t channel = Channels::DEFAULT_CHANNE
 
 void lexer::consume()
 {
-    if (input_state_->c == '\n')
+    bool new_line = input_state_->c == '\n';
+    if (new_line)
     {
         if (metrics_)
             metrics_->lines++;
         input_state_->line++;
         input_state_->char_position_in_line = static_cast<size_t>(-1);
-        input_state_->char_position_in_line_utf16 = static_cast<size_t>(-1);
     }
 
     if (input_state_->c != static_cast<char_t>(-1))
     {
         input_state_->input->consume();
-        input_state_->char_position++;
+        input_state_->char_position = input_state_->input->index();
         input_state_->c = static_cast<char_t>(input_state_->input->LA(1));
 
         input_state_->char_position_in_line++;
-        if (input_state_->c == static_cast<char32_t>(-1))
-        {
-            last_char_utf16_long_ = false;
-            input_state_->char_position_in_line_utf16 += 1;
-        }
-        else if (input_state_->c > 0xFFFF)
-        {
-            last_char_utf16_long_ = true;
-            input_state_->char_position_in_line_utf16 += 2;
-        }
-        else
-        {
-            last_char_utf16_long_ = false;
-            input_state_->char_position_in_line_utf16++;
-        }
+        if (new_line)
+            input_state_->utf16 = { input_state_->char_position, 0 };
     }
 }
 
@@ -264,8 +250,7 @@ void lexer::switch_input_streams()
 {
     if (!ainsert_buffer_.empty())
     {
-        UTF32String f = ainsert_buffer_.front();
-        ainsert_stream_->append(f);
+        ainsert_stream_->append(ainsert_buffer_.front());
         ainsert_buffer_.pop_front();
         if (input_state_->input != ainsert_stream_.get())
         {
@@ -485,16 +470,14 @@ bool lexer::identifier_divider() const
 void lexer::lex_begin()
 {
     start_token();
-    while (input_state_->char_position_in_line < begin_ && !eof() && input_state_->c != '\n')
-        consume();
+    consume_to_column(begin_);
     create_token(IGNORED, HIDDEN_CHANNEL);
 }
 
 void lexer::lex_end(bool eolln)
 {
     start_token();
-    while (input_state_->c != '\n' && !eof() && input_state_->c != (char_t)-1)
-        consume();
+    consume_to_column(static_cast<size_t>(-1));
 
     if (!eof())
     {
@@ -513,8 +496,7 @@ void lexer::lex_comment()
     while (true)
     {
         start_token();
-        while (input_state_->char_position_in_line < end_ && !eof() && input_state_->c != '\n')
-            consume();
+        consume_to_column(end_);
         create_token(COMMENT, HIDDEN_CHANNEL);
 
         if (!isspace(input_state_->c) && !eof() && continuation_enabled_)
@@ -529,6 +511,40 @@ void lexer::lex_comment()
     }
 }
 
+void lexer::consume_to_column(size_t column)
+{
+    if (input_state_ == &file_input_state_)
+    {
+        if (!lines_)
+            lines_.emplace(input_->text());
+
+        size_t pos = input_state_->char_position;
+        current_line_ = lines_->find(pos, current_line_);
+        if (current_line_ < lines_->size() && (*lines_)[current_line_].ascii)
+        {
+            // each byte is one character and one UTF-16 code unit
+            size_t count = (*lines_)[current_line_].end - pos;
+            if (input_state_->char_position_in_line >= column)
+                count = 0;
+            else
+                count = std::min(count, column - input_state_->char_position_in_line);
+
+            if (count == 0)
+                return;
+
+            input_->seek(pos + count);
+            input_state_->char_position = input_->index();
+            input_state_->c = static_cast<char_t>(input_->LA(1));
+            input_state_->char_position_in_line += count;
+            return;
+        }
+    }
+
+    while (input_state_->char_position_in_line < column && !eof() && input_state_->c != '\n'
+        && input_state_->c != static_cast<char_t>(-1))
+        consume();
+}
+
 void lexer::consume_new_line()
 {
     // we accept both separately and combine
@@ -557,8 +573,7 @@ void lexer::lex_continuation()
 
     /* lex continuation */
     start_token();
-    while (input_state_->char_position_in_line < continue_ && !eof() && input_state_->c != '\n')
-        consume();
+    consume_to_column(continue_);
     create_token(IGNORED, HIDDEN_CHANNEL);
 }
 
@@ -717,8 +732,8 @@ void lexer::insert_EOLLN()
         token_start_state_.line,
         token_start_state_.char_position_in_line,
         last_token_id_ - 1,
-        token_start_state_.char_position_in_line_utf16,
-        input_state_->char_position_in_line_utf16));
+        token_start_state_.utf16,
+        input_state_->utf16));
 
     eof_generated_ = false;
 }
@@ -782,17 +797,17 @@ size_t lexer::length_utf16(const std::string& str)
 
 std::string lexer::aread()
 {
-    string str;
-
     switch_input_streams();
 
     start_token();
 
-    while (!eof() && input_state_->c != '\n' && input_state_->c != static_cast<char_t>(-1) && str.length() < 80)
-    {
-        str.append(converter.to_bytes(input_state_->c));
+    // the line is read at most up to 80 bytes of its UTF-8 encoding
+    size_t start = input_state_->char_position;
+    while (!eof() && input_state_->c != '\n' && input_state_->c != static_cast<char_t>(-1)
+        && input_state_->char_position - start < 80)
         consume();
-    }
+
+    string str = input_state_->input->getText(antlr4::misc::Interval(start, input_state_->char_position - 1));
     create_token(AREAD, HIDDEN_CHANNEL);
     lex_end(false);
     return str;
@@ -807,8 +822,7 @@ void lexer::ainsert_front(const std::string& back) { ainsert(back, false); }
 void lexer::ainsert(const std::string& inp, bool front)
 {
     auto len = length_utf16(inp);
-    auto s = converter.from_bytes(inp);
-    UTF32String str(s.begin(), s.end());
+    std::string str = inp;
     if (len > 0)
     {
         for (; len < 80; ++len)
@@ -16,6 +16,7 @@
 #define HLASMPLUGIN_PARSER_HLASMLEX_H
 
 #include <memory>
+#include <optional>
 #include <queue>
 #include <set>
 #include <string_view>
@@ -23,6 +24,7 @@
 #include "antlr4-runtime.h"
 
 #include "input_source.h"
+#include "line_table.h"
 #include "parser_library_export.h"
 #include "range.h"
 #include "semantics/lsp_info_processor.h"
@@ -70,6 +72,8 @@ public:
 
     antlr4::CharStream* getInputStream() override;
 
+    const input_source* get_input() const { return input_; }
+
     std::string getSourceName() override;
 
     Ref<antlr4::TokenFactory<antlr4::CommonToken>> getTokenFactory() override { return dummy_factory; };
@@ -142,14 +146,13 @@ protected:
 
 private:
     bool eof_generated_ = false;
-    bool last_char_utf16_long_ = false;
     bool creating_var_symbol_ = false;
     bool creating_attr_ref_ = false;
     // insert string to the ainsert stream; to the front=True or to the end (front=False)
     void ainsert(const std::string& inp, bool front);
     std::unique_ptr<input_source> ainsert_stream_;
     // must be dequeue - inserting & poping from both ends
-    std::deque<UTF32String> ainsert_buffer_;
+    std::deque<std::string> ainsert_buffer_;
 
     std::set<size_t> tokens_after_continuation_;
     size_t last_token_id_ = 0;
@@ -160,6 +163,8 @@ private:
     stream_position last_lln_end_pos_ = { static_cast<size_t>(-1), static_cast<size_t>(-1) };
     size_t last_line_pos_;
 
+    // the factory must outlive the queued tokens
+    std::unique_ptr<token_factory> factory_;
     std::queue<token_ptr> token_queue_;
     Ref<antlr4::CommonTokenFactory> dummy_factory;
 
@@ -174,8 +179,10 @@ private:
 
     size_t tab_size_ = 1;
 
-    std::unique_ptr<token_factory> factory_;
-    antlr4::CharStream* input_;
+    input_source* input_;
+    // physical lines of input_, built when they are first needed
+    std::optional<line_table> lines_;
+    size_t current_line_ = 0;
     semantics::lsp_info_processor* lsp_proc_;
     performance_metrics* metrics_;
 
@@ -186,7 +193,10 @@ private:
         size_t line = 0;
         size_t char_position = 0;
         size_t char_position_in_line = 0;
-        size_t char_position_in_line_utf16 = 0;
+        // UTF-16 columns are computed from the last position with known column only when they are needed
+        input_source::utf16_anchor utf16;
+
+        size_t utf16_column() const { return input->utf16_column(utf16, char_position); }
     };
 
     input_state file_input_state_;
@@ -226,6 +236,9 @@ private:
 
     // lexes everything not lexed in nextToken()
     void lex_tokens();
+    // consumes characters until the column or the end of the line is reached
+    // ASCII parts of the file input are skipped at once using the line table
+    void consume_to_column(size_t column);
     // consumes '\r' and/or '\n'
     void consume_new_line();
     // lexes PROCESS instruction
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "line_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace hlasm_plugin::parser_library::lexing {
+
+namespace {
+constexpr uint64_t low_bits = 0x0101010101010101ULL;
+constexpr uint64_t high_bits = 0x8080808080808080ULL;
+
+uint64_t load_word(const char* data)
+{
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// nonzero when any byte of the word is equal to the byte
+uint64_t has_byte(uint64_t word, unsigned char byte)
+{
+    uint64_t x = word ^ (low_bits * byte);
+    return (x - low_bits) & ~x & high_bits;
+}
+} // namespace
+
+size_t find_line_break(std::string_view text, size_t from)
+{
+    size_t i = from;
+    for (; i + sizeof(uint64_t) <= text.size(); i += sizeof(uint64_t))
+    {
+        auto word = load_word(text.data() + i);
+        if (has_byte(word, '\n') || has_byte(word, '\r'))
+            break;
+    }
+    for (; i < text.size(); ++i)
+        if (text[i] == '\n' || text[i] == '\r')
+            return i;
+    return std::string_view::npos;
+}
+
+bool is_ascii(std::string_view text)
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= text.size(); i += sizeof(uint64_t))
+        if (load_word(text.data() + i) & high_bits)
+            return false;
+    for (; i < text.size(); ++i)
+        if (static_cast<unsigned char>(text[i]) & 0x80)
+            return false;
+    return true;
+}
+
+line_table::line_table(std::string_view text)
+{
+    size_t begin = 0;
+    size_t search = 0;
+    while (true)
+    {
+        auto end = find_line_break(text, search);
+        // lone '\r' does not end the line for the lexer
+        if (end != std::string_view::npos && text[end] == '\r')
+        {
+            search = end + 1;
+            continue;
+        }
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        lines_.push_back({ begin, end, is_ascii(text.substr(begin, end - begin)) });
+
+        if (end == text.size())
+            break;
+        begin = search = end + 1;
+    }
+}
+
+size_t line_table::size() const { return lines_.size(); }
+
+const line_span& line_table::operator[](size_t line) const { return lines_[line]; }
+
+size_t line_table::find(size_t offset, size_t hint) const
+{
+    auto contains = [offset](const line_span& line) { return line.begin <= offset && offset <= line.end; };
+
+    // the lexer moves forward, so the hinted line or the next one is usually the right one
+    if (hint < lines_.size() && contains(lines_[hint]))
+        return hint;
+    if (hint + 1 < lines_.size() && contains(lines_[hint + 1]))
+        return hint + 1;
+
+    auto it = std::upper_bound(lines_.begin(), lines_.end(), offset, [](size_t off, const line_span& line) {
+        return off < line.begin;
+    });
+    if (it == lines_.begin() || !contains(*(it - 1)))
+        return lines_.size();
+    return it - 1 - lines_.begin();
+}
+
+} // namespace hlasm_plugin::parser_library::lexing
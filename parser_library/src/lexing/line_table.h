@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_LINE_TABLE_H
+#define HLASMPLUGIN_PARSERLIBRARY_LINE_TABLE_H
+
+#include <string_view>
+#include <vector>
+
+namespace hlasm_plugin::parser_library::lexing {
+
+// offset of the first '\r' or '\n' at or after the offset, npos when there is none
+// the text is scanned 8 bytes at a time
+size_t find_line_break(std::string_view text, size_t from);
+
+// checks whether all the bytes are 7-bit, so that each of them is one character
+bool is_ascii(std::string_view text);
+
+// physical line as the lexer sees it, lines are separated by '\n' only
+struct line_span
+{
+    // offset of the first byte of the line
+    size_t begin;
+    // offset of the terminating '\n' or the size of the text
+    size_t end;
+    // character columns are equal to byte offsets from the line begin
+    bool ascii;
+};
+
+// Table of physical lines of a text, built in one pass before the lexing.
+// It lets the lexer skip whole parts of lines instead of consuming them character by character.
+class line_table
+{
+    std::vector<line_span> lines_;
+
+public:
+    line_table() = default;
+    explicit line_table(std::string_view text);
+
+    size_t size() const;
+    const line_span& operator[](size_t line) const;
+
+    // index of the line that contains the offset, the hint is the line that is checked first
+    // returns size() when the offset is past the text
+    size_t find(size_t offset, size_t hint = 0) const;
+};
+
+} // namespace hlasm_plugin::parser_library::lexing
+
+#endif
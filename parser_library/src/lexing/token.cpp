@@ -17,12 +17,23 @@
 #include <CharStream.h>
 #include <Interval.h>
 
+#include "token_factory.h"
+
 using namespace hlasm_plugin::parser_library::lexing;
 
-size_t token::get_end_of_token_in_line_utf16() const { return end_of_token_in_line_utf16_; }
+void* token::operator new(size_t size, token_pool& pool) { return pool.allocate(size); }
+
+void token::operator delete(void* ptr, token_pool&) { token_pool::release(ptr); }
+
+void token::operator delete(void* ptr) { token_pool::release(ptr); }
+
+size_t token::get_end_of_token_in_line_utf16() const
+{
+    return input_ ? input_->utf16_column(end_anchor_, stop_ + 1) : end_anchor_.column;
+}
 
 ::token::token(antlr4::TokenSource* source,
-    antlr4::CharStream* input,
+    input_source* input,
     size_t type,
     size_t channel,
     size_t start,
@@ -30,8 +41,8 @@ size_t token::get_end_of_token_in_line_utf16() const { return end_of_token_in_li
     size_t line,
     size_t char_position_in_line,
     size_t token_index,
-    size_t char_position_in_line_16,
-    size_t end_of_token_in_line_utf16)
+    input_source::utf16_anchor start_anchor,
+    input_source::utf16_anchor end_anchor)
     : source_(source)
     , input_(input)
     , type_(type)
@@ -41,8 +52,8 @@ size_t token::get_end_of_token_in_line_utf16() const { return end_of_token_in_li
     , line_(line)
     , char_position_in_line_(char_position_in_line)
     , token_index_(token_index)
-    , char_position_in_line_16_(char_position_in_line_16)
-    , end_of_token_in_line_utf16_(end_of_token_in_line_utf16)
+    , start_anchor_(start_anchor)
+    , end_anchor_(end_anchor)
 {}
 
 std::string token::getText() const
@@ -78,6 +89,8 @@ antlr4::TokenSource* token::getTokenSource() const { return source_; }
 
 antlr4::CharStream* token::getInputStream() const { return input_; }
 
+input_source* token::get_input_source() const { return input_; }
+
 void replace_all(std::string& str, std::string const& from, std::string const& to)
 {
     std::string new_string;
@@ -129,4 +142,7 @@ std::string token::toString() const
     return ss.str();
 }
 
-size_t token::get_char_position_in_line_16() const { return char_position_in_line_16_; }
+size_t token::get_char_position_in_line_16() const
+{
+    return input_ ? input_->utf16_column(start_anchor_, start_) : start_anchor_.column;
+}
@@ -26,11 +26,19 @@ namespace hlasm_plugin {
 namespace parser_library {
 namespace lexing {
 
+class token_pool;
+
 class token : public antlr4::Token
 {
 public:
+    // tokens are allocated only from pools of the lexers
+    static void* operator new(size_t size, token_pool& pool);
+    static void operator delete(void* ptr, token_pool& pool);
+    static void operator delete(void* ptr);
+
+    // UTF-16 columns of the token start and end are computed from the anchors when they are requested
     token(antlr4::TokenSource* source,
-        antlr4::CharStream* input,
+        input_source* input,
         size_t type,
         size_t channel,
         size_t start,
@@ -38,8 +46,8 @@ public:
         size_t line,
         size_t char_position_in_line,
         size_t token_index,
-        size_t char_position_in_line_16,
-        size_t end_of_token_in_line_utf16);
+        input_source::utf16_anchor start_anchor,
+        input_source::utf16_anchor end_anchor);
     std::string getText() const override;
 
     size_t getType() const override;
@@ -60,6 +68,8 @@ public:
 
     antlr4::CharStream* getInputStream() const override;
 
+    input_source* get_input_source() const;
+
     std::string toString() const override;
 
     size_t get_char_position_in_line_16() const;
@@ -68,7 +78,7 @@ public:
 
 private:
     antlr4::TokenSource* source_ {};
-    antlr4::CharStream* input_ {};
+    input_source* input_ {};
     size_t type_;
     size_t channel_;
     size_t start_;
@@ -76,8 +86,8 @@ private:
     size_t line_;
     size_t char_position_in_line_;
     size_t token_index_;
-    size_t char_position_in_line_16_;
-    size_t end_of_token_in_line_utf16_;
+    input_source::utf16_anchor start_anchor_;
+    input_source::utf16_anchor end_anchor_;
 };
 } // namespace lexing
 } // namespace parser_library
@@ -15,17 +15,85 @@
 #include "token_factory.h"
 
 #include <assert.h>
+#include <cstddef>
 
 using namespace hlasm_plugin;
 using namespace parser_library;
 using namespace lexing;
 
-token_factory::token_factory() = default;
+namespace {
+// each block starts with a pointer to its pool, the token follows
+constexpr size_t header_size = alignof(std::max_align_t);
+constexpr size_t block_size = header_size + (sizeof(token) + header_size - 1) / header_size * header_size;
+constexpr size_t blocks_in_slab = 512;
+} // namespace
 
-token_factory::~token_factory() = default;
+token_pool::token_pool(performance_metrics* metrics)
+    : used_in_last_slab_(blocks_in_slab)
+    , metrics_(metrics)
+{}
+
+void* token_pool::allocate(size_t size)
+{
+    assert(size <= block_size - header_size);
+
+    unsigned char* block;
+    if (free_list_)
+    {
+        block = reinterpret_cast<unsigned char*>(free_list_) - header_size;
+        free_list_ = free_list_->next;
+    }
+    else
+    {
+        if (used_in_last_slab_ == blocks_in_slab)
+        {
+            slabs_.emplace_back(new unsigned char[block_size * blocks_in_slab]);
+            used_in_last_slab_ = 0;
+            if (metrics_)
+                metrics_->token_allocations++;
+        }
+        block = slabs_.back().get() + block_size * used_in_last_slab_++;
+    }
+
+    *reinterpret_cast<token_pool**>(block) = this;
+    ++live_tokens_;
+    if (metrics_)
+        metrics_->lexed_tokens++;
+
+    return block + header_size;
+}
+
+void token_pool::release(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    auto pool = *reinterpret_cast<token_pool**>(static_cast<unsigned char*>(ptr) - header_size);
+
+    auto block = static_cast<free_block*>(ptr);
+    block->next = pool->free_list_;
+    pool->free_list_ = block;
+
+    if (--pool->live_tokens_ == 0 && pool->orphaned_)
+        delete pool;
+}
+
+void token_pool::orphan()
+{
+    orphaned_ = true;
+    metrics_ = nullptr;
+    if (live_tokens_ == 0)
+        delete this;
+}
+
+token_factory::token_factory(performance_metrics* metrics)
+    : pool_(new token_pool(metrics))
+{}
+
+token_factory::~token_factory() { pool_->orphan(); }
 
 std::unique_ptr<token> token_factory::create(antlr4::TokenSource* source,
-    antlr4::CharStream* stream,
+    input_source* stream,
     size_t type,
     size_t channel,
     size_t start,
@@ -33,10 +101,10 @@ std::unique_ptr<token> token_factory::create(antlr4::TokenSource* source,
     size_t line,
     size_t char_position_in_line,
     size_t index,
-    size_t char_position_in_line_16,
-    size_t end_of_token_in_line_utf16)
+    input_source::utf16_anchor start_anchor,
+    input_source::utf16_anchor end_anchor)
 {
-    return std::make_unique<token>(source,
+    return std::unique_ptr<token>(new (*pool_) token(source,
         stream,
         type,
         channel,
@@ -45,6 +113,6 @@ std::unique_ptr<token> token_factory::create(antlr4::TokenSource* source,
         line,
         char_position_in_line,
         index,
-        char_position_in_line_16,
-        end_of_token_in_line_utf16);
+        start_anchor,
+        end_anchor));
 }
@@ -16,21 +16,58 @@
 #define HLASMPLUGIN_PARSER_HLASMHTF_H
 
 #include <memory>
+#include <vector>
 
 #include "antlr4-runtime.h"
 
 #include "TokenFactory.h"
 #include "parser_library_export.h"
+#include "protocol.h"
 #include "token.h"
 
 namespace hlasm_plugin {
 namespace parser_library {
 namespace lexing {
 
+// Storage of tokens of one lexer. Tokens are allocated in slabs and the memory of deleted tokens
+// is reused for the next ones, so tokens of statements that were already parsed are recycled.
+// The pool is destroyed when both its factory and all its tokens are gone.
+class token_pool
+{
+public:
+    explicit token_pool(performance_metrics* metrics);
+
+    token_pool(const token_pool&) = delete;
+    token_pool& operator=(const token_pool&) = delete;
+
+    void* allocate(size_t size);
+    static void release(void* ptr);
+
+    // called by the factory, the pool deletes itself once no token is alive
+    void orphan();
+
+private:
+    ~token_pool() = default;
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    std::vector<std::unique_ptr<unsigned char[]>> slabs_;
+    size_t used_in_last_slab_;
+    free_block* free_list_ = nullptr;
+    size_t live_tokens_ = 0;
+    bool orphaned_ = false;
+    performance_metrics* metrics_;
+};
+
 class token_factory
 {
+    token_pool* pool_;
+
 public:
-    token_factory();
+    explicit token_factory(performance_metrics* metrics = nullptr);
 
     token_factory(const token_factory&) = delete;
     token_factory& operator=(const token_factory&) = delete;
@@ -40,7 +77,7 @@ public:
     ~token_factory();
 
     std::unique_ptr<token> create(antlr4::TokenSource* source,
-        antlr4::CharStream* stream,
+        input_source* stream,
         size_t type,
         size_t channel,
         size_t start,
@@ -48,8 +85,8 @@ public:
         size_t line,
         size_t char_position_in_line,
         size_t index,
-        size_t char_position_in_line_16,
-        size_t end_of_token_in_line_utf16);
+        input_source::utf16_anchor start_anchor,
+        input_source::utf16_anchor end_anchor);
 };
 
 } // namespace lexing
@@ -14,6 +14,8 @@
 
 #include "token_stream.h"
 
+#include <algorithm>
+
 using namespace hlasm_plugin::parser_library::lexing;
 using namespace antlr4;
 
@@ -22,6 +24,9 @@ token_stream::token_stream(antlr4::TokenSource* token_source)
     , enabled_cont_(false)
     , enabled_hidden_(false)
     , needSetup_(true)
+    , windowed_(false)
+    , released_(0)
+    , window_start_(0)
 {}
 
 void token_stream::enable_continuation() { enabled_cont_ = true; }
@@ -32,6 +37,21 @@ void token_stream::enable_hidden() { enabled_hidden_ = true; }
 
 void token_stream::disable_hidden() { enabled_hidden_ = false; }
 
+void token_stream::enable_windowing() { windowed_ = true; }
+
+void token_stream::disable_windowing() { windowed_ = false; }
+
+void token_stream::release_processed()
+{
+    if (!windowed_)
+        return;
+
+    for (auto end = std::min(window_start_, _tokens.size()); released_ < end; ++released_)
+        _tokens[released_].reset();
+
+    window_start_ = std::min(_p, _tokens.size());
+}
+
 void token_stream::rewind_input(lexer::stream_position pos)
 {
     auto& lexer_tmp = dynamic_cast<lexer&>(*_tokenSource);
@@ -42,7 +62,8 @@ void token_stream::rewind_input(lexer::stream_position pos)
     lexer_tmp.rewind_input(pos);
 
     if (_tokens.back()->getType() != lexer::EOLLN
-        || (_tokens.size() > 1 && _tokens[_tokens.size() - 2]->getType() == lexer::EOLLN))
+        || (_tokens.size() > 1 && _tokens[_tokens.size() - 2]
+            && _tokens[_tokens.size() - 2]->getType() == lexer::EOLLN))
     {
         auto index_tmp = _tokens.back()->getTokenIndex();
         _tokens.pop_back();
@@ -59,6 +80,8 @@ void token_stream::reset()
     _tokens.clear();
     _fetchedEOF = false;
     _p = 0;
+    released_ = 0;
+    window_start_ = 0;
     sync(0);
 }
 
@@ -114,6 +137,8 @@ std::string token_stream::getText(const antlr4::misc::Interval& interval)
     for (size_t i = start; i <= stop; i++)
     {
         Token* t = _tokens[i].get();
+        if (!t) // freed by release_processed
+            continue;
         if (t->getType() == Token::EOF)
         {
             break;
@@ -172,6 +197,9 @@ antlr4::Token* token_stream::LB(size_t k)
 
         antlr4::Token* token = get(i);
 
+        if (!token) // freed by release_processed
+            return nullptr;
+
         if (is_on_channel(token))
             ++n;
     }
@@ -221,6 +249,9 @@ size_t token_stream::previous_token_on_channel(size_t i)
     {
         antlr4::Token* token = get(i);
 
+        if (!token) // freed by release_processed
+            return i + 1;
+
         if (is_on_channel(token))
         {
             if (--to_skip == 0)
@@ -34,6 +34,11 @@ class token_stream : public antlr4::BufferedTokenStream
     bool enabled_cont_;
     bool enabled_hidden_;
     bool needSetup_;
+    bool windowed_;
+    // tokens before this index are already freed
+    size_t released_;
+    // index of the first token of the last processed statement
+    size_t window_start_;
 
 public:
     token_stream(antlr4::TokenSource* token_source);
@@ -48,6 +53,15 @@ public:
     // disable hidden token channel
     void disable_hidden();
 
+    // free tokens of processed statements (see release_processed)
+    void enable_windowing();
+    // keep all tokens for the whole lifetime of the stream
+    void disable_windowing();
+    // frees tokens of statements processed before the last one, the last one is kept for lookback
+    // the indices of the remaining tokens do not change
+    // rewinds re-lex the input from the given position, so they do not need the freed tokens
+    void release_processed();
+
     antlr4::Token* LT(ssize_t k) override;
 
     std::string getText(const antlr4::misc::Interval& interval) override;
@@ -22,6 +22,9 @@ lib_config lib_config::make_default()
 {
     lib_config def_config;
     def_config.diag_supress_limit = 10;
+    def_config.parallel_analysis_workers = 1;
+    def_config.persistent_macro_cache = false;
+    def_config.defer_macro_ca_operands = false;
 
     return def_config;
 }
@@ -38,6 +41,22 @@ lib_config lib_config::load_from_json(const nlohmann::json& config)
             loaded.diag_supress_limit = 0;
     }
 
+    found = config.find("parallelAnalysisWorkers");
+    if (found != config.end())
+    {
+        loaded.parallel_analysis_workers = found->get<int64_t>();
+        if (loaded.parallel_analysis_workers < 1)
+            loaded.parallel_analysis_workers = 1;
+    }
+
+    found = config.find("persistentMacroCache");
+    if (found != config.end())
+        loaded.persistent_macro_cache = found->get<bool>();
+
+    found = config.find("deferMacroCaOperands");
+    if (found != config.end())
+        loaded.defer_macro_ca_operands = found->get<bool>();
+
 
     return loaded;
 }
@@ -52,12 +71,21 @@ lib_config lib_config::combine_two_configs(const lib_config& second) const
     lib_config combined(*this);
     if (!combined.diag_supress_limit.has_value())
         combined.diag_supress_limit = second.diag_supress_limit;
+    if (!combined.parallel_analysis_workers.has_value())
+        combined.parallel_analysis_workers = second.parallel_analysis_workers;
+    if (!combined.persistent_macro_cache.has_value())
+        combined.persistent_macro_cache = second.persistent_macro_cache;
+    if (!combined.defer_macro_ca_operands.has_value())
+        combined.defer_macro_ca_operands = second.defer_macro_ca_operands;
     return combined;
 }
 
 bool operator==(const lib_config& lhs, const lib_config& rhs)
 {
-    return lhs.diag_supress_limit == rhs.diag_supress_limit;
+    return lhs.diag_supress_limit == rhs.diag_supress_limit
+        && lhs.parallel_analysis_workers == rhs.parallel_analysis_workers
+        && lhs.persistent_macro_cache == rhs.persistent_macro_cache
+        && lhs.defer_macro_ca_operands == rhs.defer_macro_ca_operands;
 }
 
 } // namespace hlasm_plugin::parser_library
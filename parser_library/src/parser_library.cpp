@@ -40,6 +40,8 @@ void parser_library::parse(const std::string& src)
     a.parser().addErrorListener(l);
     a.parser().getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(
         antlr4::atn::PredictionMode::LL_EXACT_AMBIG_DETECTION);
+    // all the tokens are printed after the analysis
+    dynamic_cast<token_stream&>(*a.parser().getTokenStream()).disable_windowing();
 
     a.analyze();
 
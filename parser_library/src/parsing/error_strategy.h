@@ -89,8 +89,9 @@ class error_strategy : public antlr4::DefaultErrorStrategy
 
         lexing::lexer* lex = dynamic_cast<lexing::lexer*>(recognizer->getTokenStream()->getTokenSource());
         // return specialized tokens
+        // the token is not in the input, its columns are given explicitly
         _errorSymbols.push_back(lex->get_token_factory()->create(current->getTokenSource(),
-            current->getInputStream(),
+            current->get_input_source(),
             expectedTokenType,
             Token::DEFAULT_CHANNEL,
             INVALID_INDEX,
@@ -98,8 +99,8 @@ class error_strategy : public antlr4::DefaultErrorStrategy
             current->getLine(),
             current->getCharPositionInLine(),
             (size_t)-1,
-            current->get_char_position_in_line_16(),
-            current->get_end_of_token_in_line_utf16()));
+            { INVALID_INDEX, current->get_char_position_in_line_16() },
+            { INVALID_INDEX, current->get_end_of_token_in_line_utf16() }));
 
         return _errorSymbols.back().get();
     }
@@ -24,7 +24,9 @@ ca_op returns [operand_ptr op]
 
 		resolve_expression($expr_list.ca_expr);
 		auto r = provider.get_range($expr_list.ctx->getStart(),$seq_symbol.ctx->getStop());
-		$op = std::make_unique<branch_ca_operand>(std::move($seq_symbol.ss), std::move($expr_list.ca_expr), r);
+		auto op = std::make_unique<branch_ca_operand>(std::move($seq_symbol.ss), std::move($expr_list.ca_expr), r);
+		op->bytecode = compile_expression(*op->expression);
+		$op = std::move(op);
 	}
 	| seq_symbol
 	{
@@ -35,7 +37,9 @@ ca_op returns [operand_ptr op]
 	| {!is_var_def()}? expr
 	{
 		resolve_expression($expr.ca_expr);
-		$op = std::make_unique<expr_ca_operand>(std::move($expr.ca_expr), provider.get_range($expr.ctx));
+		auto op = std::make_unique<expr_ca_operand>(std::move($expr.ca_expr), provider.get_range($expr.ctx));
+		op->bytecode = compile_expression(*op->expression);
+		$op = std::move(op);
 	}
 	| { is_var_def()}? var_def
 	{
@@ -377,5 +377,18 @@ op_rem_body_mac_r returns [op_rem line]
 	} EOLLN EOF
 	| EOLLN EOF;
 
+//////////////////////////////////////// ca_r
+
+op_rem_body_ca_r returns [op_rem line]
+	: op_rem_body_alt_ca
+	{
+		$line = std::move($op_rem_body_alt_ca.line);
+	} EOLLN EOF
+	| remark_o 
+	{
+		$line.remarks = $remark_o.value ? remark_list{*$remark_o.value} : remark_list{};
+	} EOLLN EOF
+	| EOLLN EOF;
+
 op_rem_body_noop_r
 	: remark_o EOLLN EOF;
\ No newline at end of file
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "operand_field_cache.h"
+
+#include <functional>
+
+#include "expressions/data_definition.h"
+#include "expressions/mach_expression.h"
+#include "expressions/nominal_value.h"
+#include "semantics/concatenation_term.h"
+
+namespace hlasm_plugin::parser_library::parsing {
+
+bool operand_field_cache_key::operator==(const operand_field_cache_key& other) const
+{
+    const auto& [format, opcode] = status;
+    const auto& [other_format, other_opcode] = other.status;
+    return field == other.field && format == other_format && opcode.value == other_opcode.value
+        && opcode.type == other_opcode.type && field_range.original_range == other.field_range.original_range
+        && field_range.original_operand_ranges == other.field_range.original_operand_ranges
+        && field_range.state == other.field_range.state && file_name == other.file_name;
+}
+
+size_t operand_field_cache_key_hash::operator()(const operand_field_cache_key& key) const
+{
+    size_t result = std::hash<std::string>()(key.field);
+    auto combine = [&result](size_t value) { result ^= value + 0x9e3779b9 + (result << 6) + (result >> 2); };
+
+    const auto& [format, opcode] = key.status;
+    combine((size_t)format.form);
+    combine(std::hash<context::id_index>()(opcode.value));
+    combine(key.field_range.original_range.start.line);
+    combine(key.field_range.original_range.start.column);
+    return result;
+}
+
+namespace {
+
+using namespace expressions;
+using namespace semantics;
+
+mach_expr_ptr clone_expr(const mach_expr_ptr& expr) { return expr ? expr->clone() : nullptr; }
+
+// variable symbols are never present after substitution, chains with them are not copied
+std::optional<concat_chain> clone_chain(const concat_chain& chain)
+{
+    concat_chain result;
+    for (const auto& point : chain)
+    {
+        if (!point)
+        {
+            result.push_back(nullptr);
+            continue;
+        }
+        switch (point->type)
+        {
+            case concat_type::STR:
+                result.push_back(std::make_unique<char_str_conc>(point->access_str()->value));
+                break;
+            case concat_type::DOT:
+                result.push_back(std::make_unique<dot_conc>());
+                break;
+            case concat_type::EQU:
+                result.push_back(std::make_unique<equals_conc>());
+                break;
+            case concat_type::SUB: {
+                std::vector<concat_chain> list;
+                for (const auto& item : point->access_sub()->list)
+                {
+                    auto item_copy = clone_chain(item);
+                    if (!item_copy)
+                        return std::nullopt;
+                    list.push_back(std::move(*item_copy));
+                }
+                result.push_back(std::make_unique<sublist_conc>(std::move(list)));
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+    return result;
+}
+
+nominal_value_ptr clone_nominal(const nominal_value_ptr& nominal)
+{
+    if (!nominal)
+        return nullptr;
+
+    if (auto str = nominal->access_string())
+        return std::make_unique<nominal_value_string>(str->value, str->value_range);
+
+    expr_or_address_list exprs;
+    for (const auto& e : nominal->access_exprs()->exprs)
+    {
+        if (std::holds_alternative<mach_expr_ptr>(e))
+            exprs.emplace_back(clone_expr(std::get<mach_expr_ptr>(e)));
+        else
+        {
+            const auto& addr = std::get<address_nominal>(e);
+            exprs.emplace_back(address_nominal(clone_expr(addr.displacement), clone_expr(addr.base)));
+        }
+    }
+    return std::make_unique<nominal_value_exprs>(std::move(exprs));
+}
+
+data_definition clone_data_def(const data_definition& dd)
+{
+    data_definition result;
+    result.dupl_factor = clone_expr(dd.dupl_factor);
+    result.type = dd.type;
+    result.type_range = dd.type_range;
+    result.extension = dd.extension;
+    result.extension_range = dd.extension_range;
+    result.program_type = clone_expr(dd.program_type);
+    result.length = clone_expr(dd.length);
+    result.scale = clone_expr(dd.scale);
+    result.exponent = clone_expr(dd.exponent);
+    result.nominal_value = clone_nominal(dd.nominal_value);
+    result.length_type = dd.length_type;
+    result.diags() = dd.diags();
+    return result;
+}
+
+std::unique_ptr<complex_assembler_operand::component_value_t> clone_component(
+    const complex_assembler_operand::component_value_t& value)
+{
+    using op = complex_assembler_operand;
+    if (auto int_value = dynamic_cast<const op::int_value_t*>(&value))
+        return std::make_unique<op::int_value_t>(int_value->value, int_value->op_range);
+    if (auto string_value = dynamic_cast<const op::string_value_t*>(&value))
+        return std::make_unique<op::string_value_t>(string_value->value, string_value->op_range);
+
+    const auto& composite = dynamic_cast<const op::composite_value_t&>(value);
+    std::vector<std::unique_ptr<op::component_value_t>> values;
+    for (const auto& v : composite.values)
+        values.push_back(clone_component(*v));
+    return std::make_unique<op::composite_value_t>(composite.identifier, std::move(values), composite.op_range);
+}
+
+std::unique_ptr<evaluable_operand> clone_machine_operand(machine_operand& op)
+{
+    if (auto expr = op.access_expr())
+        return std::make_unique<expr_machine_operand>(clone_expr(expr->expression), expr->operand_range);
+
+    auto addr = op.access_address();
+    return std::make_unique<address_machine_operand>(clone_expr(addr->displacement),
+        clone_expr(addr->first_par),
+        clone_expr(addr->second_par),
+        addr->operand_range,
+        addr->state);
+}
+
+std::unique_ptr<evaluable_operand> clone_assembler_operand(assembler_operand& op)
+{
+    switch (op.kind)
+    {
+        case asm_kind::EXPR: {
+            auto expr = op.access_expr();
+            return std::make_unique<expr_assembler_operand>(
+                clone_expr(expr->expression), expr->get_value(), expr->operand_range);
+        }
+        case asm_kind::BASE_END: {
+            auto using_op = op.access_base_end();
+            return std::make_unique<using_instr_assembler_operand>(
+                clone_expr(using_op->base), clone_expr(using_op->end), using_op->operand_range);
+        }
+        case asm_kind::COMPLEX: {
+            auto complex = op.access_complex();
+            std::vector<std::unique_ptr<complex_assembler_operand::component_value_t>> values;
+            for (const auto& v : complex->value.values)
+                values.push_back(clone_component(*v));
+            return std::make_unique<complex_assembler_operand>(
+                complex->value.identifier, std::move(values), complex->operand_range);
+        }
+        case asm_kind::STRING: {
+            auto str = op.access_string();
+            return std::make_unique<string_assembler_operand>(str->value, str->operand_range);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+operand_ptr clone_operand(operand& op)
+{
+    switch (op.type)
+    {
+        case operand_type::EMPTY:
+            return std::make_unique<empty_operand>(op.operand_range);
+        case operand_type::MODEL: {
+            auto chain = clone_chain(op.access_model()->chain);
+            if (!chain)
+                return nullptr;
+            return std::make_unique<model_operand>(std::move(*chain), op.operand_range);
+        }
+        case operand_type::MAC: {
+            auto mac = op.access_mac();
+            if (mac->kind == mac_kind::STRING)
+                return std::make_unique<macro_operand_string>(mac->access_string()->value, op.operand_range);
+            auto chain = clone_chain(mac->access_chain()->chain);
+            if (!chain)
+                return nullptr;
+            return std::make_unique<macro_operand_chain>(std::move(*chain), op.operand_range);
+        }
+        case operand_type::MACH:
+        case operand_type::ASM:
+        case operand_type::DAT: {
+            std::unique_ptr<evaluable_operand> result;
+            if (op.type == operand_type::MACH)
+                result = clone_machine_operand(*op.access_mach());
+            else if (op.type == operand_type::ASM)
+                result = clone_assembler_operand(*op.access_asm());
+            else
+                result = std::make_unique<data_def_operand>(
+                    clone_data_def(*op.access_data_def()->value), op.operand_range);
+
+            if (result)
+                result->diags() = dynamic_cast<const evaluable_operand&>(op).diags();
+            return result;
+        }
+        default:
+            // conditional assembly operands are never reparsed after substitution
+            return nullptr;
+    }
+}
+
+} // namespace
+
+std::optional<operand_list> operand_field_cache::clone(const operand_list& operands)
+{
+    operand_list result;
+    result.reserve(operands.size());
+    for (const auto& op : operands)
+    {
+        if (!op)
+        {
+            result.push_back(nullptr);
+            continue;
+        }
+        auto copy = clone_operand(*op);
+        if (!copy)
+            return std::nullopt;
+        result.push_back(std::move(copy));
+    }
+    return result;
+}
+
+operand_field_cache::operand_field_cache(size_t capacity)
+    : capacity_(capacity)
+{}
+
+std::optional<operand_field_cache_entry> operand_field_cache::find(const operand_field_cache_key& key)
+{
+    auto found = index_.find(key);
+    if (found == index_.end())
+        return std::nullopt;
+
+    auto it = found->second;
+    entries_.splice(entries_.begin(), entries_, it);
+
+    const auto& cached = it->second;
+    operand_field_cache_entry result;
+    result.operands = std::move(*clone(cached.operands));
+    result.operands_range = cached.operands_range;
+    result.remarks = cached.remarks;
+    result.remarks_range = cached.remarks_range;
+    result.listener_diags = cached.listener_diags;
+    result.parser_diags = cached.parser_diags;
+    return result;
+}
+
+void operand_field_cache::insert(operand_field_cache_key key, const operand_field_cache_entry& entry)
+{
+    if (capacity_ == 0 || index_.find(key) != index_.end())
+        return;
+
+    auto operands = clone(entry.operands);
+    if (!operands)
+        return;
+
+    if (entries_.size() >= capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+
+    operand_field_cache_entry cached;
+    cached.operands = std::move(*operands);
+    cached.operands_range = entry.operands_range;
+    cached.remarks = entry.remarks;
+    cached.remarks_range = entry.remarks_range;
+    cached.listener_diags = entry.listener_diags;
+    cached.parser_diags = entry.parser_diags;
+
+    entries_.emplace_front(std::move(key), std::move(cached));
+    index_.emplace(entries_.front().first, entries_.begin());
+}
+
+size_t operand_field_cache::size() const { return entries_.size(); }
+
+void operand_field_cache::clear()
+{
+    index_.clear();
+    entries_.clear();
+}
+
+} // namespace hlasm_plugin::parser_library::parsing
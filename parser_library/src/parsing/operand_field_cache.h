@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_OPERAND_FIELD_CACHE_H
+#define HLASMPLUGIN_PARSERLIBRARY_OPERAND_FIELD_CACHE_H
+
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "diagnostic.h"
+#include "processing/op_code.h"
+#include "semantics/operand.h"
+#include "semantics/range_provider.h"
+
+namespace hlasm_plugin::parser_library::parsing {
+
+// Identifies one parse of an operand field. Two parses with equal keys produce equal operands and diagnostics.
+struct operand_field_cache_key
+{
+    std::string field;
+    processing::processing_status status;
+    semantics::range_provider field_range;
+    // file that the diagnostics of the parser are reported to
+    std::string file_name;
+
+    bool operator==(const operand_field_cache_key& other) const;
+};
+
+struct operand_field_cache_key_hash
+{
+    size_t operator()(const operand_field_cache_key& key) const;
+};
+
+// Result of one parse of an operand field together with the diagnostics that the parse produced.
+struct operand_field_cache_entry
+{
+    semantics::operand_list operands;
+    range operands_range;
+    std::vector<range> remarks;
+    range remarks_range;
+
+    // diagnostics reported by the error listener, they get the processing stack when they are reported again
+    std::vector<diagnostic_op> listener_diags;
+    // diagnostics reported by the parser itself
+    std::vector<diagnostic_s> parser_diags;
+};
+
+// Bounded cache of operand fields parsed after substitution of variable symbols.
+// Macro loops tend to substitute the same values into the same statements over and over,
+// so the parse results are kept and handed out as deep copies, because the operands are modified during processing.
+// The least recently used entry is dropped when the cache is full.
+class operand_field_cache
+{
+    using lru_list = std::list<std::pair<operand_field_cache_key, operand_field_cache_entry>>;
+
+    lru_list entries_;
+    std::unordered_map<operand_field_cache_key, lru_list::iterator, operand_field_cache_key_hash> index_;
+    size_t capacity_;
+
+public:
+    static constexpr size_t default_capacity = 1024;
+
+    explicit operand_field_cache(size_t capacity = default_capacity);
+
+    // Returns a copy of the cached entry or nullopt if the key is not present.
+    std::optional<operand_field_cache_entry> find(const operand_field_cache_key& key);
+
+    // Stores a copy of the entry. Entries that contain operands which cannot be copied are not stored.
+    void insert(operand_field_cache_key key, const operand_field_cache_entry& entry);
+
+    size_t size() const;
+    void clear();
+
+    // Creates a deep copy of the operands, returns nullopt when one of them cannot be copied.
+    static std::optional<semantics::operand_list> clone(const semantics::operand_list& operands);
+};
+
+} // namespace hlasm_plugin::parser_library::parsing
+
+#endif
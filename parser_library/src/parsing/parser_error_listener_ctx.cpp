@@ -31,6 +31,12 @@ void parser_error_listener_ctx::add_parser_diagnostic(
 {
     if (substituted_)
         message = "While substituting to '" + *substituted_ + "' => " + message;
-    add_diagnostic(
-        diagnostic_op(severity, std::move(code), std::move(message), provider_.adjust_range(diagnostic_range)));
+    parser_diagnostics_.emplace_back(
+        severity, std::move(code), std::move(message), provider_.adjust_range(diagnostic_range));
+    add_diagnostic(parser_diagnostics_.back());
+}
+
+const std::vector<diagnostic_op>& parser_error_listener_ctx::parser_diagnostics() const
+{
+    return parser_diagnostics_;
 }
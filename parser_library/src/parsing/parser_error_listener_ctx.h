@@ -32,6 +32,9 @@ public:
 
     virtual void collect_diags() const override;
 
+    // diagnostics reported by the parser, before the processing stack is applied
+    const std::vector<diagnostic_op>& parser_diagnostics() const;
+
 protected:
     virtual void add_parser_diagnostic(
         range diagnostic_range, diagnostic_severity severity, std::string code, std::string message) override;
@@ -39,6 +42,7 @@ protected:
 private:
     std::optional<std::string> substituted_;
     semantics::range_provider provider_;
+    std::vector<diagnostic_op> parser_diagnostics_;
 };
 
 } // namespace hlasm_plugin::parser_library::parsing
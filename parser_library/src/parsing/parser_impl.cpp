@@ -15,6 +15,7 @@
 #include "parser_impl.h"
 
 #include <cctype>
+#include <iterator>
 
 #include "error_strategy.h"
 #include "expressions/conditional_assembly/terms/ca_constant.h"
@@ -34,7 +35,9 @@ parser_impl::parser_impl(antlr4::TokenStream* input)
     , processor(nullptr)
     , finished_flag(false)
     , provider()
-{}
+{
+    provider.input = dynamic_cast<lexing::lexer&>(*input->getTokenSource()).get_input();
+}
 
 void parser_impl::initialize(context::hlasm_context* hlasm_ctx,
     semantics::lsp_info_processor* lsp_prc,
@@ -83,12 +86,114 @@ std::unique_ptr<parser_holder> create_parser_holder()
     return h;
 }
 
+template<typename Rule>
+auto parser_impl::parse_rest(const std::function<void()>& prepare, antlr4::ANTLRErrorListener& listener, Rule rule)
+{
+    hlasmparser& parser = *rest_parser_->parser;
+    auto& interpreter = *parser.getInterpreter<antlr4::atn::ParserATNSimulator>();
+    auto diags_count = parser.diags().size();
+
+    auto start = [&]() {
+        prepare();
+        parser.reset();
+        parser.collector.prepare_for_next_statement();
+    };
+
+    // SLL prediction is much cheaper and suffices for almost all operands,
+    // the first syntax error cancels the parse instead of recovering from it
+    interpreter.setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+    parser.removeErrorListeners();
+    start();
+    parser.ctx->metrics.sll_parses++;
+    try
+    {
+        return rule(parser);
+    }
+    catch (const antlr4::ParseCancellationException&)
+    {}
+
+    // either a syntax error or an operand that needs full context, parse again and report errors
+    parser.ctx->metrics.ll_fallbacks++;
+    parser.diags().erase(parser.diags().begin() + diags_count, parser.diags().end());
+
+    interpreter.setPredictionMode(antlr4::atn::PredictionMode::LL);
+    parser.setErrorHandler(std::make_shared<error_strategy>());
+    parser.addErrorListener(&listener);
+    start();
+    return rule(parser);
+}
+
+std::optional<simple_operand_field> parser_impl::parse_simple_operands(std::string_view text,
+    position start,
+    bool leading_spaces,
+    bool limited_line,
+    context::id_storage& ids,
+    semantics::range_provider& range_prov)
+{
+    if (!simple_operands_)
+        return std::nullopt;
+
+    auto field = parse_simple_operand_field(text, start, leading_spaces, limited_line, ids, range_prov);
+    if (!field)
+        return std::nullopt;
+
+    auto& coll = rest_parser_->parser->collector;
+    coll.prepare_for_next_statement();
+    for (auto& symbol : field->hl_symbols)
+        coll.add_hl_symbol(std::move(symbol));
+    for (const auto& [name, symbol_range] : field->lsp_symbols)
+        coll.add_lsp_symbol(name, symbol_range, context::symbol_type::ord);
+    return field;
+}
+
+void parser_impl::set_simple_operand_parsing(bool enabled) { simple_operands_ = enabled; }
+
 std::pair<semantics::operands_si, semantics::remarks_si> parser_impl::parse_operand_field(
     context::hlasm_context* hlasm_ctx,
     std::string field,
     bool after_substitution,
     semantics::range_provider field_range,
     processing::processing_status status)
+{
+    return parse_field(hlasm_ctx, std::move(field), after_substitution, std::move(field_range), status, nullptr);
+}
+
+std::pair<processing::statement_fields_parser::parse_result, context::deferred_parse_effects>
+parser_impl::parse_deferred_operand_field(context::hlasm_context* hlasm_ctx,
+    std::string field,
+    semantics::range_provider field_range,
+    processing::processing_status status)
+{
+    context::deferred_parse_effects effects;
+    auto result = parse_field(hlasm_ctx, std::move(field), false, std::move(field_range), status, &effects);
+    return std::make_pair(std::move(result), std::move(effects));
+}
+
+void parser_impl::report_deferred_effects(
+    context::hlasm_context* hlasm_ctx, const context::deferred_parse_effects& effects)
+{
+    if (!rest_parser_)
+        rest_parser_ = create_parser_holder();
+
+    parser_error_listener_ctx listener(*hlasm_ctx, std::nullopt);
+    for (const auto& diag : effects.listener_diags)
+        listener.add_diagnostic(diag);
+    collect_diags_from_child(listener);
+    for (const auto& diag : effects.parser_diags)
+        rest_parser_->parser->add_diagnostic(diag);
+
+    if (!effects.lsp_symbols.empty())
+        lsp_proc->process_lsp_symbols(
+            effects.lsp_symbols, ctx->ids().add(ctx->processing_stack().back().proc_location.file, true));
+}
+
+std::pair<semantics::operands_si, semantics::remarks_si> parser_impl::parse_field(context::hlasm_context* hlasm_ctx,
+    std::string field,
+    bool after_substitution,
+    semantics::range_provider field_range,
+    processing::processing_status status,
+    context::deferred_parse_effects* effects)
 {
     if (!rest_parser_)
         rest_parser_ = create_parser_holder();
@@ -96,62 +201,106 @@ std::pair<semantics::operands_si, semantics::remarks_si> parser_impl::parse_oper
     hlasm_ctx->metrics.reparsed_statements++;
     const parser_holder& h = *rest_parser_;
 
+    // deferred operands are parsed only once per statement and have LSP side effects, only substituted fields are cached
+    std::optional<operand_field_cache_key> cache_key;
+    if (after_substitution)
+    {
+        cache_key = operand_field_cache_key {
+            field, status, field_range, hlasm_ctx->processing_stack().back().proc_location.file
+        };
+        if (auto cached = operand_cache_.find(*cache_key))
+        {
+            hlasm_ctx->metrics.reparse_cache_hits++;
+
+            parser_error_listener_ctx listener(*hlasm_ctx, std::nullopt);
+            for (auto& diag : cached->listener_diags)
+                listener.add_diagnostic(std::move(diag));
+            collect_diags_from_child(listener);
+            for (auto& diag : cached->parser_diags)
+                h.parser->add_diagnostic(std::move(diag));
+
+            return std::make_pair(semantics::operands_si(cached->operands_range, std::move(cached->operands)),
+                semantics::remarks_si(cached->remarks_range, std::move(cached->remarks)));
+        }
+    }
+    auto parser_diags_count = h.parser->diags().size();
+
     std::optional<std::string> sub;
     if (after_substitution)
         sub = field;
     parser_error_listener_ctx listener(*hlasm_ctx, std::move(sub));
 
-    h.input->reset(field);
+    auto prepare = [&]() {
+        h.input->reset(field);
 
-    h.lex->reset();
-    h.lex->set_file_offset(field_range.original_range.start);
-    h.lex->set_unlimited_line(after_substitution);
+        h.lex->reset();
+        h.lex->set_file_offset(field_range.original_range.start);
+        h.lex->set_unlimited_line(after_substitution);
 
-    h.stream->reset();
+        h.stream->reset();
 
-    h.parser->initialize(hlasm_ctx, field_range, status);
-    h.parser->setErrorHandler(std::make_shared<error_strategy>());
-    h.parser->removeErrorListeners();
-    h.parser->addErrorListener(&listener);
-    h.parser->reset();
-
-    h.parser->collector.prepare_for_next_statement();
+        h.parser->initialize(hlasm_ctx, field_range, status);
+    };
+    auto parse_line = [&](auto rule) { return std::move(parse_rest(prepare, listener, rule)->line); };
 
     semantics::op_rem line;
     auto& [format, opcode] = status;
     if (format.occurence == processing::operand_occurence::ABSENT
         || format.form == processing::processing_form::UNKNOWN)
-        h.parser->op_rem_body_noop();
+        parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_noop(); });
     else
     {
         switch (format.form)
         {
             case processing::processing_form::MAC:
-                line = std::move(h.parser->op_rem_body_mac_r()->line);
+                line = parse_line([](hlasmparser& p) { return p.op_rem_body_mac_r(); });
                 parse_macro_operands(line);
                 break;
             case processing::processing_form::ASM:
-                line = std::move(h.parser->op_rem_body_asm_r()->line);
+                line = parse_line([](hlasmparser& p) { return p.op_rem_body_asm_r(); });
                 break;
             case processing::processing_form::MACH:
-                line = std::move(h.parser->op_rem_body_mach_r()->line);
+                if (auto simple = parse_simple_operands(field,
+                        field_range.original_range.start,
+                        false,
+                        !after_substitution,
+                        hlasm_ctx->ids(),
+                        field_range))
+                    line = std::move(simple->line);
+                else
+                    line = parse_line([](hlasmparser& p) { return p.op_rem_body_mach_r(); });
                 break;
             case processing::processing_form::DAT:
-                line = std::move(h.parser->op_rem_body_dat_r()->line);
+                line = parse_line([](hlasmparser& p) { return p.op_rem_body_dat_r(); });
+                break;
+            case processing::processing_form::CA:
+                line = parse_line([](hlasmparser& p) { return p.op_rem_body_ca_r(); });
                 break;
             default:
                 break;
         }
     }
 
-    // indicates that the reparse reason is to resolve deferred operands (and not to substitute varsymbols)
-    if (!after_substitution)
+    if (effects)
     {
-        lsp_proc->process_lsp_symbols(h.parser->collector.extract_lsp_symbols(),
-            ctx->ids().add(ctx->processing_stack().back().proc_location.file, true));
+        effects->lsp_symbols = h.parser->collector.extract_lsp_symbols();
+        effects->listener_diags = listener.parser_diagnostics();
+        auto& parser_diags = h.parser->diags();
+        effects->parser_diags.assign(std::make_move_iterator(parser_diags.begin() + parser_diags_count),
+            std::make_move_iterator(parser_diags.end()));
+        parser_diags.erase(parser_diags.begin() + parser_diags_count, parser_diags.end());
     }
+    else
+    {
+        // indicates that the reparse reason is to resolve deferred operands (and not to substitute varsymbols)
+        if (!after_substitution)
+        {
+            lsp_proc->process_lsp_symbols(h.parser->collector.extract_lsp_symbols(),
+                ctx->ids().add(ctx->processing_stack().back().proc_location.file, true));
+        }
 
-    collect_diags_from_child(listener);
+        collect_diags_from_child(listener);
+    }
 
     for (size_t i = 0; i < line.operands.size(); i++)
     {
@@ -173,6 +322,19 @@ std::pair<semantics::operands_si, semantics::remarks_si> parser_impl::parse_oper
         ? range(op_range.end)
         : semantics::range_provider::union_range(line.remarks.front(), line.remarks.back());
 
+    if (cache_key)
+    {
+        operand_field_cache_entry entry;
+        entry.operands = std::move(line.operands);
+        entry.operands_range = op_range;
+        entry.remarks = line.remarks;
+        entry.remarks_range = rem_range;
+        entry.listener_diags = listener.parser_diagnostics();
+        entry.parser_diags.assign(h.parser->diags().begin() + parser_diags_count, h.parser->diags().end());
+        operand_cache_.insert(std::move(*cache_key), entry);
+        line.operands = std::move(entry.operands);
+    }
+
     return std::make_pair(semantics::operands_si(op_range, std::move(line.operands)),
         semantics::remarks_si(rem_range, std::move(line.remarks)));
 }
@@ -309,6 +471,15 @@ void parser_impl::resolve_expression(expressions::ca_expr_ptr& expr) const
     }
 }
 
+std::shared_ptr<const expressions::ca_bytecode> parser_impl::compile_expression(
+    const expressions::ca_expression& expr) const
+{
+    auto kind = proc_status->first.kind;
+    if (kind != processing::processing_kind::MACRO && kind != processing::processing_kind::COPY)
+        return nullptr;
+    return expressions::ca_bytecode::compile(expr);
+}
+
 bool parser_impl::process_instruction()
 {
     if (processor->kind == processing::processing_kind::ORDINARY
@@ -371,6 +542,8 @@ void parser_impl::process_next(processing::statement_processor& proc)
     processor = nullptr;
     collector.prepare_for_next_statement();
     proc_status.reset();
+
+    input.release_processed();
 }
 
 bool parser_impl::finished() const { return finished_flag; }
@@ -452,7 +625,9 @@ void parser_impl::initialize(
     context::hlasm_context* hlasm_ctx, semantics::range_provider range_prov, processing::processing_status proc_stat)
 {
     ctx = hlasm_ctx;
-    provider = range_prov;
+    // the tokens are still read from the same input
+    range_prov.input = provider.input;
+    provider = std::move(range_prov);
     proc_status = proc_stat;
 }
 
@@ -468,24 +643,19 @@ semantics::operand_list parser_impl::parse_macro_operands(
 
     parser_error_listener_ctx listener(*ctx, std::nullopt, tmp_provider);
 
-    h.input->reset(operands);
-
-    h.lex->reset();
-    h.lex->set_file_offset(field_range.start);
-    h.lex->set_unlimited_line(true);
-
-    h.stream->reset();
+    auto prepare = [&]() {
+        h.input->reset(operands);
 
-    h.parser->initialize(ctx, tmp_provider, *proc_status);
-    h.parser->setErrorHandler(std::make_shared<error_strategy>());
-    h.parser->removeErrorListeners();
-    h.parser->addErrorListener(&listener);
+        h.lex->reset();
+        h.lex->set_file_offset(field_range.start);
+        h.lex->set_unlimited_line(true);
 
-    h.parser->reset();
+        h.stream->reset();
 
-    h.parser->collector.prepare_for_next_statement();
+        h.parser->initialize(ctx, tmp_provider, *proc_status);
+    };
 
-    auto list = std::move(h.parser->macro_ops()->list);
+    auto list = std::move(parse_rest(prepare, listener, [](hlasmparser& p) { return p.macro_ops(); })->list);
 
     collect_diags_from_child(listener);
 
@@ -532,42 +702,37 @@ void parser_impl::parse_operands(const std::string& text, range text_range)
 
     parser_error_listener_ctx listener(*ctx, std::nullopt);
 
-    h.input->reset(text);
+    auto prepare = [&]() {
+        h.input->reset(text);
 
-    h.lex->reset();
-    h.lex->set_file_offset(text_range.start);
-    h.lex->set_unlimited_line(false);
+        h.lex->reset();
+        h.lex->set_file_offset(text_range.start);
+        h.lex->set_unlimited_line(false);
 
-    h.stream->reset();
+        h.stream->reset();
 
-    h.parser->initialize(ctx, provider, *proc_status);
-    h.parser->setErrorHandler(std::make_shared<error_strategy>());
-    h.parser->removeErrorListeners();
-    h.parser->addErrorListener(&listener);
-
-    h.parser->reset();
-
-    h.parser->collector.prepare_for_next_statement();
+        h.parser->initialize(ctx, provider, *proc_status);
+    };
 
     auto& [format, opcode] = *proc_status;
     if (format.occurence == processing::operand_occurence::ABSENT
         || format.form == processing::processing_form::UNKNOWN)
-        h.parser->op_rem_body_noop();
+        parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_noop(); });
     else
     {
         switch (format.form)
         {
             case processing::processing_form::IGNORED:
-                h.parser->op_rem_body_ignored();
+                parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_ignored(); });
                 break;
             case processing::processing_form::DEFERRED:
-                h.parser->op_rem_body_deferred();
+                parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_deferred(); });
                 break;
             case processing::processing_form::CA:
-                h.parser->op_rem_body_ca();
+                parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_ca(); });
                 break;
             case processing::processing_form::MAC: {
-                auto rule = h.parser->op_rem_body_mac();
+                auto rule = parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_mac(); });
                 auto line = std::move(rule->line);
                 auto line_range = rule->line_range;
                 parse_macro_operands(line);
@@ -576,13 +741,17 @@ void parser_impl::parse_operands(const std::string& text, range text_range)
             }
             break;
             case processing::processing_form::ASM:
-                h.parser->op_rem_body_asm();
+                parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_asm(); });
                 break;
             case processing::processing_form::MACH:
-                h.parser->op_rem_body_mach();
+                if (auto simple = parse_simple_operands(text, text_range.start, true, true, ctx->ids(), provider))
+                    h.parser->collector.set_operand_remark_field(
+                        std::move(simple->line.operands), std::move(simple->line.remarks), simple->line_range);
+                else
+                    parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_mach(); });
                 break;
             case processing::processing_form::DAT:
-                h.parser->op_rem_body_dat();
+                parse_rest(prepare, listener, [](hlasmparser& p) { return p.op_rem_body_dat(); });
                 break;
             default:
                 break;
@@ -628,24 +797,19 @@ void parser_impl::parse_lookahead_operands(const std::string& text, range text_r
 
     parser_error_listener_ctx listener(*ctx, std::nullopt);
 
-    h.input->reset(text);
-
-    h.lex->reset();
-    h.lex->set_file_offset(text_range.start);
-    h.lex->set_unlimited_line(true);
-
-    h.stream->reset();
+    auto prepare = [&]() {
+        h.input->reset(text);
 
-    h.parser->initialize(ctx, provider, *proc_status);
-    h.parser->setErrorHandler(std::make_shared<error_strategy>());
-    h.parser->removeErrorListeners();
-    h.parser->addErrorListener(&listener);
+        h.lex->reset();
+        h.lex->set_file_offset(text_range.start);
+        h.lex->set_unlimited_line(true);
 
-    h.parser->reset();
+        h.stream->reset();
 
-    h.parser->collector.prepare_for_next_statement();
+        h.parser->initialize(ctx, provider, *proc_status);
+    };
 
-    h.parser->lookahead_operands_and_remarks();
+    parse_rest(prepare, listener, [](hlasmparser& p) { return p.lookahead_operands_and_remarks(); });
 
     h.parser->collector.clear_hl_lsp_symbols();
     collector.append_operand_field(std::move(h.parser->collector));
@@ -15,16 +15,21 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_PARSER_IMPL_H
 #define HLASMPLUGIN_PARSERLIBRARY_PARSER_IMPL_H
 
+#include <functional>
+
 #include "antlr4-runtime.h"
 
 #include "context/hlasm_context.h"
 #include "diagnosable.h"
+#include "expressions/conditional_assembly/ca_bytecode.h"
 #include "lexing/lexer.h"
+#include "operand_field_cache.h"
 #include "processing/opencode_provider.h"
 #include "processing/statement_fields_parser.h"
 #include "processing/statement_providers/statement_provider.h"
 #include "semantics/collector.h"
 #include "semantics/lsp_info_processor.h"
+#include "simple_operand_parser.h"
 
 namespace hlasm_plugin {
 namespace parser_library {
@@ -67,9 +72,21 @@ public:
         semantics::range_provider field_range,
         processing::processing_status status) override;
 
+    virtual std::pair<processing::statement_fields_parser::parse_result, context::deferred_parse_effects>
+    parse_deferred_operand_field(context::hlasm_context* hlasm_ctx,
+        std::string field,
+        semantics::range_provider field_range,
+        processing::processing_status status) override;
+
+    virtual void report_deferred_effects(
+        context::hlasm_context* hlasm_ctx, const context::deferred_parse_effects& effects) override;
+
     void collect_diags() const override;
     std::vector<antlr4::ParserRuleContext*> tree;
 
+    // Enables the hand-written recognizer of simple machine instruction operands (enabled by default).
+    void set_simple_operand_parsing(bool enabled);
+
 protected:
     void enable_continuation();
     void disable_continuation();
@@ -86,6 +103,8 @@ protected:
     void resolve_expression(expressions::ca_expr_ptr& expr, context::SET_t_enum type) const;
     void resolve_expression(std::vector<expressions::ca_expr_ptr>& expr, context::SET_t_enum type) const;
     void resolve_expression(expressions::ca_expr_ptr& expr) const;
+    // compiles the expression of a statement stored in a macro or copy definition, returns nullptr otherwise
+    std::shared_ptr<const expressions::ca_bytecode> compile_expression(const expressions::ca_expression& expr) const;
 
     // process methods return true if attribute lookahead needed
     bool process_instruction();
@@ -118,6 +137,8 @@ protected:
 
 private:
     std::unique_ptr<parser_holder> rest_parser_;
+    operand_field_cache operand_cache_;
+    bool simple_operands_ = true;
     workspaces::parse_lib_provider* lib_provider_;
     processing::processing_state_listener* state_listener_;
 
@@ -125,9 +146,32 @@ private:
         semantics::range_provider range_prov,
         processing::processing_status proc_stat);
 
+    // parses the operand field, the side effects are stored to the effects instead of being reported when given
+    processing::statement_fields_parser::parse_result parse_field(context::hlasm_context* hlasm_ctx,
+        std::string field,
+        bool after_substitution,
+        semantics::range_provider field_range,
+        processing::processing_status status,
+        context::deferred_parse_effects* effects);
+
     semantics::operand_list parse_macro_operands(
         std::string operands, range field_range, std::vector<range> operand_ranges);
 
+    // Tries to recognize the operand field of a machine instruction without ANTLR.
+    // On success, the symbols of the field are added to the collector of the operand parser.
+    std::optional<simple_operand_field> parse_simple_operands(std::string_view text,
+        position start,
+        bool leading_spaces,
+        bool limited_line,
+        context::id_storage& ids,
+        semantics::range_provider& range_prov);
+
+    // Runs the rule on the parser of operand fields prepared by the prepare function.
+    // The rule is parsed with SLL prediction first, full LL prediction with error recovery is used
+    // only when the SLL parse fails.
+    template<typename Rule>
+    auto parse_rest(const std::function<void()>& prepare, antlr4::ANTLRErrorListener& listener, Rule rule);
+
     void process_ordinary();
     void process_lookahead();
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "simple_operand_parser.h"
+
+#include <cstdint>
+
+#include "expressions/mach_expr_term.h"
+#include "expressions/mach_operator.h"
+
+namespace hlasm_plugin::parser_library::parsing {
+
+namespace {
+
+// column where the continuation of the line begins
+constexpr size_t continuation_column = 71;
+// longest decimal number that certainly fits into a self defining term
+constexpr size_t max_number_length = 9;
+
+using namespace expressions;
+
+// Recursive descent over the characters of the field, mirrors the tokens the lexer would create.
+// Any method returns false when the input is not simple enough.
+class simple_parser
+{
+    std::string_view text_;
+    position start_;
+    context::id_storage& ids_;
+    semantics::range_provider& provider_;
+    size_t i_ = 0;
+
+public:
+    simple_operand_field result;
+
+    simple_parser(std::string_view text, position start, context::id_storage& ids, semantics::range_provider& provider)
+        : text_(text)
+        , start_(start)
+        , ids_(ids)
+        , provider_(provider)
+    {}
+
+    bool parse_field(bool leading_spaces)
+    {
+        if (leading_spaces)
+        {
+            if (!skip_spaces())
+                return false;
+        }
+
+        size_t field_begin = i_;
+        do
+        {
+            if (!parse_operand())
+                return false;
+        } while (consume_operator(','));
+
+        size_t field_end = i_;
+        if (i_ != text_.size())
+        {
+            // the only remaining possibility is a remark
+            if (!skip_spaces() || i_ == text_.size())
+                return false;
+            result.line.remarks.push_back(get_range(i_, text_.size()));
+            field_end = text_.size();
+        }
+
+        result.line_range = get_range(field_begin, field_end);
+        return true;
+    }
+
+private:
+    char current() const { return i_ < text_.size() ? text_[i_] : '\0'; }
+
+    range get_range(size_t begin, size_t end) const
+    {
+        return provider_.adjust_range(range(position(start_.line, start_.column + begin),
+            position(start_.line, start_.column + end)));
+    }
+
+    bool skip_spaces()
+    {
+        if (current() != ' ')
+            return false;
+        while (current() == ' ')
+            ++i_;
+        return true;
+    }
+
+    void add_hl_symbol(size_t begin, size_t end, semantics::hl_scopes scope)
+    {
+        result.hl_symbols.emplace_back(get_range(begin, end), scope);
+    }
+
+    bool consume_operator(char c)
+    {
+        if (current() != c)
+            return false;
+        add_hl_symbol(i_, i_ + 1, semantics::hl_scopes::operator_symbol);
+        ++i_;
+        return true;
+    }
+
+    static bool is_word_char(char c)
+    {
+        switch (c)
+        {
+            case '\0':
+            case ' ':
+            case '*':
+            case '.':
+            case '-':
+            case '+':
+            case '=':
+            case '<':
+            case '>':
+            case ',':
+            case '(':
+            case ')':
+            case '\'':
+            case '/':
+            case '&':
+            case '|':
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    static bool is_ord_char(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '@'
+            || c == '$' || c == '#';
+    }
+
+    static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+    // ordinary symbol, decimal number or location counter
+    mach_expr_ptr parse_term()
+    {
+        size_t begin = i_;
+        if (current() == '*')
+        {
+            // asterisk in the first column starts a comment
+            if (start_.column + i_ == 0)
+                return nullptr;
+            ++i_;
+            add_hl_symbol(begin, i_, semantics::hl_scopes::operand);
+            return std::make_unique<mach_expr_location_counter>(get_range(begin, i_));
+        }
+
+        while (is_word_char(current()))
+            ++i_;
+        auto word = text_.substr(begin, i_ - begin);
+        if (word.empty())
+            return nullptr;
+
+        if (is_digit(word.front()))
+        {
+            if (word.size() > max_number_length)
+                return nullptr;
+            int32_t value = 0;
+            for (char c : word)
+            {
+                if (!is_digit(c))
+                    return nullptr;
+                value = value * 10 + (c - '0');
+            }
+            add_hl_symbol(begin, i_, semantics::hl_scopes::number);
+            return std::make_unique<mach_expr_constant>(value, get_range(begin, i_));
+        }
+
+        if (word.size() > 63)
+            return nullptr;
+        for (char c : word)
+            if (!is_ord_char(c))
+                return nullptr;
+        // one letter symbols may start a data attribute reference that the grammar decides by a predicate
+        if (word.size() == 1)
+            return nullptr;
+
+        auto r = get_range(begin, i_);
+        add_hl_symbol(begin, i_, semantics::hl_scopes::ordinary_symbol);
+        auto name = ids_.add(std::string(word));
+        result.lsp_symbols.emplace_back(name, r);
+        return std::make_unique<mach_expr_symbol>(name, r);
+    }
+
+    // terms joined by + and -
+    mach_expr_ptr parse_expr()
+    {
+        size_t begin = i_;
+        auto expr = parse_term();
+        if (!expr)
+            return nullptr;
+
+        while (current() == '+' || current() == '-')
+        {
+            bool plus = current() == '+';
+            consume_operator(current());
+            auto next = parse_term();
+            if (!next)
+                return nullptr;
+            if (plus)
+                expr = std::make_unique<mach_expr_binary<add>>(std::move(expr), std::move(next), get_range(begin, i_));
+            else
+                expr = std::make_unique<mach_expr_binary<sub>>(std::move(expr), std::move(next), get_range(begin, i_));
+        }
+
+        // multiplication, division and anything else that follows the expression is left to the parser
+        switch (current())
+        {
+            case '\0':
+            case ' ':
+            case ',':
+            case '(':
+            case ')':
+                return expr;
+            default:
+                return nullptr;
+        }
+    }
+
+    bool parse_operand()
+    {
+        size_t begin = i_;
+        auto disp = parse_expr();
+        if (!disp)
+            return false;
+
+        if (!consume_operator('('))
+        {
+            result.line.operands.push_back(
+                std::make_unique<semantics::expr_machine_operand>(std::move(disp), get_range(begin, i_)));
+            return true;
+        }
+
+        mach_expr_ptr first;
+        mach_expr_ptr second;
+        checking::operand_state state;
+        if (consume_operator(','))
+        {
+            if (!(second = parse_expr()))
+                return false;
+            state = checking::operand_state::FIRST_OMITTED;
+        }
+        else
+        {
+            if (!(first = parse_expr()))
+                return false;
+            if (!consume_operator(','))
+            {
+                second = std::move(first);
+                state = checking::operand_state::ONE_OP;
+            }
+            else if (current() == ')')
+                state = checking::operand_state::SECOND_OMITTED;
+            else
+            {
+                if (!(second = parse_expr()))
+                    return false;
+                state = checking::operand_state::PRESENT;
+            }
+        }
+        if (!consume_operator(')'))
+            return false;
+        if (current() != '\0' && current() != ' ' && current() != ',')
+            return false;
+
+        result.line.operands.push_back(std::make_unique<semantics::address_machine_operand>(
+            std::move(disp), std::move(first), std::move(second), get_range(begin, i_), state));
+        return true;
+    }
+};
+
+} // namespace
+
+std::optional<simple_operand_field> parse_simple_operand_field(std::string_view text,
+    position start,
+    bool leading_spaces,
+    bool limited_line,
+    context::id_storage& ids,
+    semantics::range_provider& provider)
+{
+    if (limited_line && start.column + text.size() >= continuation_column)
+        return std::nullopt;
+    // lines, continuations and non-ASCII characters whose columns differ from the byte offsets
+    for (char c : text)
+        if (c < ' ' || c > '~')
+            return std::nullopt;
+
+    simple_parser parser(text, start, ids, provider);
+    if (!parser.parse_field(leading_spaces))
+        return std::nullopt;
+    return std::move(parser.result);
+}
+
+} // namespace hlasm_plugin::parser_library::parsing
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_SIMPLE_OPERAND_PARSER_H
+#define HLASMPLUGIN_PARSERLIBRARY_SIMPLE_OPERAND_PARSER_H
+
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "context/id_storage.h"
+#include "protocol.h"
+#include "semantics/operand.h"
+#include "semantics/range_provider.h"
+
+namespace hlasm_plugin::parser_library::parsing {
+
+// operand field of a machine instruction recognized without the ANTLR parser
+struct simple_operand_field
+{
+    semantics::op_rem line;
+    range line_range;
+    std::vector<token_info> hl_symbols;
+    // ordinary symbols referenced in the operands
+    std::vector<std::pair<context::id_index, range>> lsp_symbols;
+};
+
+// Hand-written recognizer of the most common operand fields of machine instructions.
+// Recognizes comma separated operands made of ordinary symbols, decimal numbers and location counters joined
+// by + and -, optionally followed by the address part (B), (X,B), (,B) or (X,), and an optional remark.
+// The result is the same as the one of the op_rem_body_mach rules of hlasmparser.
+// Returns nullopt for anything else (variable symbols, strings, attributes, literals, continuations, ...),
+// such fields are left to the ANTLR parser.
+// leading_spaces - whether the field starts with the spaces that separate it from the instruction
+// limited_line - whether the field is subject to the continuation column
+std::optional<simple_operand_field> parse_simple_operand_field(std::string_view text,
+    position start,
+    bool leading_spaces,
+    bool limited_line,
+    context::id_storage& ids,
+    semantics::range_provider& provider);
+
+} // namespace hlasm_plugin::parser_library::parsing
+
+#endif
@@ -109,7 +109,7 @@ context_manager::name_result context_manager::try_get_symbol_name(const std::str
 }
 
 bool context_manager::test_symbol_for_read(
-    const context::var_sym_ptr& var, const std::vector<context::A_t>& subscript, range symbol_range) const
+    context::variable_symbol* var, const std::vector<context::A_t>& subscript, range symbol_range) const
 {
     if (!var)
     {
@@ -46,7 +46,7 @@ public:
     name_result try_get_symbol_name(const std::string& symbol) const;
 
     bool test_symbol_for_read(
-        const context::var_sym_ptr& var, const std::vector<context::A_t>& subscript, range symbol_range) const;
+        context::variable_symbol* var, const std::vector<context::A_t>& subscript, range symbol_range) const;
 
     virtual void collect_diags() const override;
 
@@ -159,7 +159,7 @@ bool ca_processor::prepare_SET_symbol(const semantics::complete_statement& stmt,
 }
 
 bool ca_processor::prepare_SET_operands(
-    const semantics::complete_statement& stmt, std::vector<expressions::ca_expression*>& expr_values)
+    const semantics::complete_statement& stmt, std::vector<const semantics::expr_ca_operand*>& expr_values)
 {
     bool has_operand = false;
     for (auto& op : stmt.operands_ref().value)
@@ -178,7 +178,7 @@ bool ca_processor::prepare_SET_operands(
             return false;
         }
 
-        expr_values.push_back(ca_op->access_expr()->expression.get());
+        expr_values.push_back(ca_op->access_expr());
     }
 
     if (!has_operand)
@@ -265,7 +265,7 @@ bool ca_processor::prepare_ACTR(const semantics::complete_statement& stmt, conte
 
     if (ca_op->kind == semantics::ca_kind::EXPR || ca_op->kind == semantics::ca_kind::VAR)
     {
-        ctr = ca_op->access_expr()->expression->evaluate<context::A_t>(eval_ctx);
+        ctr = evaluate_operand<context::A_t>(*ca_op->access_expr());
         return true;
     }
     else
@@ -325,7 +325,7 @@ bool ca_processor::prepare_AGO(const semantics::complete_statement& stmt,
     if (ca_op->kind == semantics::ca_kind::BRANCH)
     {
         auto br_op = ca_op->access_branch();
-        branch = br_op->expression->evaluate<context::A_t>(eval_ctx);
+        branch = evaluate_operand<context::A_t>(*br_op);
         targets.emplace_back(br_op->sequence_symbol.name, br_op->sequence_symbol.symbol_range);
 
         for (size_t i = 1; i < stmt.operands_ref().value.size(); ++i)
@@ -397,7 +397,7 @@ bool ca_processor::prepare_AIF(
             if (!condition)
             {
                 auto br = ca_op->access_branch();
-                condition = br->expression->evaluate<context::B_t>(eval_ctx);
+                condition = evaluate_operand<context::B_t>(*br);
 
                 target = br->sequence_symbol.name;
                 target_range = br->sequence_symbol.symbol_range;
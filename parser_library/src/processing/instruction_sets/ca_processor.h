@@ -51,6 +51,15 @@ private:
 
     process_table_t create_table(context::hlasm_context& hlasm_ctx);
 
+    // evaluates the expression of the operand, using its compiled form when present
+    template<typename T, typename OPERAND>
+    T evaluate_operand(const OPERAND& op) const
+    {
+        if (op.bytecode)
+            return op.bytecode->template evaluate<T>(eval_ctx);
+        return op.expression->template evaluate<T>(eval_ctx);
+    }
+
     void register_seq_sym(const semantics::complete_statement& stmt);
 
     bool test_symbol_for_assignment(const semantics::variable_symbol* symbol,
@@ -64,7 +73,7 @@ private:
         context::set_symbol_base*& set_symbol,
         context::id_index& name);
     bool prepare_SET_operands(
-        const semantics::complete_statement& stmt, std::vector<expressions::ca_expression*>& expr_values);
+        const semantics::complete_statement& stmt, std::vector<const semantics::expr_ca_operand*>& expr_values);
 
     template<typename T>
     void process_SET(const semantics::complete_statement& stmt);
@@ -104,7 +113,7 @@ private:
 template<typename T>
 inline void ca_processor::process_SET(const semantics::complete_statement& stmt)
 {
-    std::vector<expressions::ca_expression*> expr_values;
+    std::vector<const semantics::expr_ca_operand*> expr_values;
     int index;
     context::id_index name;
     context::set_symbol_base* set_symbol;
@@ -122,7 +131,7 @@ inline void ca_processor::process_SET(const semantics::complete_statement& stmt)
         return;
 
     for (size_t i = 0; i < expr_values.size(); i++)
-        set_symbol->access_set_symbol<T>()->set_value(expr_values[i]->evaluate<T>(eval_ctx), index - 1 + i);
+        set_symbol->access_set_symbol<T>()->set_value(evaluate_operand<T>(*expr_values[i]), index - 1 + i);
 }
 
 template<typename T, bool global>
@@ -56,7 +56,7 @@ processing_manager::processing_manager(std::unique_ptr<opencode_provider> base_p
         case processing_kind::MACRO:
             hlasm_ctx.push_statement_processing(processing_kind::MACRO, std::move(file_name));
             procs_.emplace_back(std::make_unique<macrodef_processor>(
-                hlasm_ctx, *this, lib_provider, macrodef_start_data(data.library_member)));
+                hlasm_ctx, *this, lib_provider, macrodef_start_data(data.library_member, data.defer_ca_operands)));
             break;
         default:
             break;
@@ -169,10 +169,18 @@ void processing_manager::finish_macro_definition(macrodef_processing_result resu
 
 void processing_manager::start_lookahead(lookahead_start_data start)
 {
-    // jump to the statement where the previous lookahead stopped
-    if (hlasm_ctx_.current_source().end_index < lookahead_stop_.end_index)
+    // jump to the statement where the previous lookahead stopped,
+    // statements before it were already searched and their symbols registered
+    if (hlasm_ctx_.current_source().create_snapshot().precedes(lookahead_stop_))
+    {
+        auto snapshot = lookahead_stop_;
+        // continue after the last statement of the previous lookahead, as in the open code
+        if (!snapshot.copy_frames.empty())
+            ++snapshot.copy_frames.back().statement_offset;
+
         perform_opencode_jump(
-            context::source_position(lookahead_stop_.end_line + 1, lookahead_stop_.end_index), lookahead_stop_);
+            context::source_position(snapshot.end_line + 1, snapshot.end_index), std::move(snapshot));
+    }
 
     hlasm_ctx_.push_statement_processing(processing_kind::LOOKAHEAD);
     procs_.emplace_back(
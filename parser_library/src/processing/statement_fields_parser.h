@@ -15,6 +15,7 @@
 #ifndef PROCESSING_STATEMENT_FIELDS_PARSER_H
 #define PROCESSING_STATEMENT_FIELDS_PARSER_H
 
+#include "context/cached_statement.h"
 #include "context/hlasm_context.h"
 #include "semantics/range_provider.h"
 
@@ -37,6 +38,18 @@ public:
         semantics::range_provider field_range,
         processing::processing_status status) = 0;
 
+    // parses the operand field of a deferred statement stored in a macro or copy definition
+    // the diagnostics and LSP symbols of the parse are not reported, they are returned with the result,
+    // because the parsed statement is shared and each analysis reports them with report_deferred_effects
+    virtual std::pair<parse_result, context::deferred_parse_effects> parse_deferred_operand_field(
+        context::hlasm_context* hlasm_ctx,
+        std::string field,
+        semantics::range_provider field_range,
+        processing::processing_status status) = 0;
+
+    virtual void report_deferred_effects(
+        context::hlasm_context* hlasm_ctx, const context::deferred_parse_effects& effects) = 0;
+
     virtual ~statement_fields_parser() = default;
 };
 
@@ -26,14 +26,18 @@ struct macrodef_start_data
 {
     bool is_external;
     context::id_index external_name;
+    // operands of conditional assembly statements are parsed when the statements are executed
+    bool defer_ca_operands;
 
     macrodef_start_data()
         : is_external(false)
         , external_name(context::id_storage::empty_id)
+        , defer_ca_operands(false)
     {}
-    macrodef_start_data(context::id_index external_name)
+    macrodef_start_data(context::id_index external_name, bool defer_ca_operands = false)
         : is_external(true)
         , external_name(external_name)
+        , defer_ca_operands(defer_ca_operands)
     {}
 };
 
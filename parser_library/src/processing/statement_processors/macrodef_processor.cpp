@@ -67,7 +67,16 @@ processing_status macrodef_processor::get_processing_status(const semantics::ins
     }
     else
     {
-        return get_macro_processing_status(instruction, hlasm_ctx);
+        auto status = get_macro_processing_status(instruction, hlasm_ctx);
+
+        // when enabled, operands of conditional assembly instructions in library macros are parsed when the
+        // statement is executed for the first time, statements in branches that are never taken are not parsed
+        // at all and their syntax errors are not reported
+        if (start_.defer_ca_operands && status.first.form == processing_form::CA
+            && status.first.occurence == operand_occurence::PRESENT)
+            return std::make_pair(processing_format(processing_kind::MACRO, processing_form::DEFERRED), op_code());
+
+        return status;
     }
 }
 
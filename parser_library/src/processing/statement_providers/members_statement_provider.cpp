@@ -16,6 +16,24 @@
 
 namespace hlasm_plugin::parser_library::processing {
 
+namespace {
+// compiles the CA expressions of the statement, so that its repeated executions do not walk the expression trees
+void compile_ca_operands(semantics::operands_si& operands)
+{
+    for (auto& op : operands.value)
+    {
+        auto ca_op = op->access_ca();
+        if (!ca_op)
+            continue;
+
+        if (auto expr_op = ca_op->access_expr())
+            expr_op->bytecode = expressions::ca_bytecode::compile(*expr_op->expression);
+        else if (auto branch_op = ca_op->access_branch())
+            branch_op->bytecode = expressions::ca_bytecode::compile(*branch_op->expression);
+    }
+}
+} // namespace
+
 members_statement_provider::members_statement_provider(const statement_provider_kind kind,
     context::hlasm_context& hlasm_ctx,
     statement_fields_parser& parser,
@@ -76,6 +94,7 @@ void members_statement_provider::fill_cache(context::cached_statement_storage& c
     const processing_status& status)
 {
     context::cached_statement_storage::cache_entry_t ptr;
+    context::deferred_effects_ptr effects;
     auto def_impl = std::dynamic_pointer_cast<const semantics::statement_si_deferred>(cache.get_base());
 
     if (status.first.occurence == operand_occurence::ABSENT || status.first.form == processing_form::UNKNOWN
@@ -88,15 +107,19 @@ void members_statement_provider::fill_cache(context::cached_statement_storage& c
     }
     else
     {
-        auto [op, rem] = parser.parse_operand_field(&hlasm_ctx,
+        auto [field, parse_effects] = parser.parse_deferred_operand_field(&hlasm_ctx,
             def_stmt.deferred_ref(),
-            false,
             semantics::range_provider(def_stmt.deferred_range_ref(), semantics::adjusting_state::NONE),
             status);
+        auto& [op, rem] = field;
+
+        if (status.first.form == processing_form::CA)
+            compile_ca_operands(op);
 
         ptr = std::make_shared<semantics::statement_si_defer_done>(def_impl, std::move(op), std::move(rem));
+        effects = std::make_shared<const context::deferred_parse_effects>(std::move(parse_effects));
     }
-    cache.insert(status.first.form, ptr);
+    cache.insert(status.first.form, ptr, std::move(effects));
 }
 
 void members_statement_provider::preprocess_deferred(
@@ -104,6 +127,20 @@ void members_statement_provider::preprocess_deferred(
 {
     const auto& def_stmt = *cache.get_base()->access_deferred();
 
+    // the resolution of a constant operation code in the ordinary processing changes only with OPSYN and macro
+    // definitions, so the resolved statement is reused until the operation code generation of the context changes
+    bool reusable = processor.kind == processing_kind::ORDINARY
+        && def_stmt.instruction_ref().type != semantics::instruction_si_type::CONC;
+
+    if (reusable)
+    {
+        if (auto resolved = cache.get_resolved(hlasm_ctx.opcode_generation()))
+        {
+            do_process_statement(processor, std::move(resolved));
+            return;
+        }
+    }
+
     auto status = processor.get_processing_status(def_stmt.instruction_ref());
 
     if (status.first.form == processing_form::DEFERRED)
@@ -115,6 +152,22 @@ void members_statement_provider::preprocess_deferred(
     if (!cache.contains(status.first.form))
         fill_cache(cache, def_stmt, status);
 
+    // the definition may be shared with other analyses, which parsed the statement first
+    if (auto effects = cache.get_effects(status.first.form); effects && reported_effects_.insert(effects).second)
+        parser.report_deferred_effects(&hlasm_ctx, *effects);
+
+    // only statements that are not retained by their processing are shared,
+    // postponed assembler and machine statements refer to the statement they were created from
+    if (reusable && (status.first.form == processing_form::CA || status.first.form == processing_form::MAC))
+    {
+        context::shared_stmt_ptr resolved =
+            std::make_shared<resolved_statement_impl>(cache.get(status.first.form), status.second, status.first);
+        cache.set_resolved(hlasm_ctx.opcode_generation(), resolved);
+
+        do_process_statement(processor, std::move(resolved));
+        return;
+    }
+
     context::unique_stmt_ptr cached =
         std::make_unique<resolved_statement_impl>(cache.get(status.first.form), status.second, status.first);
 
@@ -15,6 +15,8 @@
 #ifndef PROCESSING_MEMBERS_STATEMENT_PROVIDER_H
 #define PROCESSING_MEMBERS_STATEMENT_PROVIDER_H
 
+#include <unordered_set>
+
 #include "context/cached_statement.h"
 #include "context/hlasm_context.h"
 #include "expressions/evaluation_context.h"
@@ -45,6 +47,10 @@ protected:
     virtual context::cached_statement_storage* get_next() = 0;
 
 private:
+    // effects of the parses of deferred statements already reported by this analysis
+    // a statement reuses its resolved form only in the analysis that reported the effects
+    std::unordered_set<context::deferred_effects_ptr> reported_effects_;
+
     const semantics::instruction_si& retrieve_instruction(context::cached_statement_storage& cache) const;
 
     void fill_cache(context::cached_statement_storage& cache,
@@ -24,7 +24,7 @@ using namespace hlasm_plugin::parser_library::semantics;
 using namespace hlasm_plugin::parser_library::context;
 
 lsp_info_processor::lsp_info_processor(
-    std::string file, const std::string& text, context::hlasm_context* ctx, bool collect_hl_info)
+    std::string file, std::string_view text, context::hlasm_context* ctx, bool collect_hl_info)
     : file_name(ctx ? ctx->ids().add(file, true) : nullptr)
     , empty_string(ctx ? ctx->ids().well_known.empty : nullptr)
     , ctx_(ctx)
@@ -32,10 +32,12 @@ lsp_info_processor::lsp_info_processor(
     , instruction_regex("^([^*][^*]\\S*\\s+\\S+|\\s+\\S*)")
 {
     // initialize text vector
-    std::string line;
-    std::stringstream text_ss(text);
-    while (std::getline(text_ss, line))
-        text_.push_back(line);
+    for (size_t start = 0; start < text.size();)
+    {
+        auto end = std::min(text.find('\n', start), text.size());
+        text_.emplace_back(text.substr(start, end - start));
+        start = end + 1;
+    }
 
     if (!ctx)
         return;
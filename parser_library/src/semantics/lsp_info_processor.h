@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <regex>
+#include <string_view>
 #include <vector>
 
 #include "context/hlasm_context.h"
@@ -55,7 +56,7 @@ struct completion_list_s
 class lsp_info_processor
 {
 public:
-    lsp_info_processor(std::string file, const std::string& text, context::hlasm_context* ctx, bool collect_hl_info);
+    lsp_info_processor(std::string file, std::string_view text, context::hlasm_context* ctx, bool collect_hl_info);
 
     // name of file this processor is currently used
     const std::string* file_name;
@@ -273,6 +273,8 @@ expr_assembler_operand::expr_assembler_operand(
     , value_(std::move(string_value))
 {}
 
+const std::string& expr_assembler_operand::get_value() const { return value_; }
+
 std::unique_ptr<checking::operand> expr_assembler_operand::get_operand_value(expressions::mach_evaluate_info info) const
 {
     return get_operand_value_inner(info, true);
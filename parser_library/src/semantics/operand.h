@@ -20,6 +20,7 @@
 #include "checking/data_definition/data_definition_operand.h"
 #include "checking/instr_operand.h"
 #include "concatenation_term.h"
+#include "expressions/conditional_assembly/ca_bytecode.h"
 #include "expressions/data_definition.h"
 #include "expressions/mach_expression.h"
 
@@ -238,6 +239,8 @@ private:
 public:
     expr_assembler_operand(expressions::mach_expr_ptr expression, std::string string_value, const range operand_range);
 
+    const std::string& get_value() const;
+
     virtual std::unique_ptr<checking::operand> get_operand_value(expressions::mach_evaluate_info info) const override;
 
     std::unique_ptr<checking::operand> get_operand_value(
@@ -452,6 +455,8 @@ struct expr_ca_operand final : ca_operand
         const expressions::evaluation_context& eval_ctx) override;
 
     expressions::ca_expr_ptr expression;
+    // compiled expression, present in statements cached by macro and copy definitions
+    std::shared_ptr<const expressions::ca_bytecode> bytecode;
 };
 
 // CA sequence symbol operand
@@ -477,6 +482,8 @@ struct branch_ca_operand final : ca_operand
 
     seq_sym sequence_symbol;
     expressions::ca_expr_ptr expression;
+    // compiled expression, present in statements cached by macro and copy definitions
+    std::shared_ptr<const expressions::ca_bytecode> bytecode;
 };
 
 
@@ -14,6 +14,8 @@
 
 #include "range_provider.h"
 
+#include "lexing/input_source.h"
+
 using namespace hlasm_plugin::parser_library;
 using namespace hlasm_plugin::parser_library::semantics;
 
@@ -44,7 +46,15 @@ range range_provider::get_range(const antlr4::Token* start, const antlr4::Token*
     if (stop)
     {
         ret.end.line = stop->getLine();
-        ret.end.column = stop->getCharPositionInLine() + stop->getStopIndex() - stop->getStartIndex() + 1;
+        auto start_index = stop->getStartIndex();
+        auto stop_index = stop->getStopIndex();
+        // indices of the lexed tokens are byte offsets to UTF-8 text,
+        // tokens of other streams (e.g. AINSERT buffer) are measured in bytes
+        auto column = stop->getCharPositionInLine();
+        if (input && stop->getInputStream() == input && start_index <= stop_index)
+            ret.end.column = input->utf16_column({ start_index, column }, stop_index + 1);
+        else
+            ret.end.column = column + stop_index - start_index + 1;
     }
     else // empty rule
     {
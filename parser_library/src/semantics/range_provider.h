@@ -21,6 +21,9 @@
 
 namespace hlasm_plugin {
 namespace parser_library {
+namespace lexing {
+class input_source;
+}
 namespace semantics {
 
 // state of range adjusting
@@ -38,6 +41,8 @@ public:
     range original_range;
     std::vector<range> original_operand_ranges;
     adjusting_state state;
+    // text of the tokens, their indices are byte offsets to it
+    const lexing::input_source* input = nullptr;
 
     range_provider(range original_field_range, adjusting_state state);
     range_provider(range original_field_range, std::vector<range> original_operand_ranges, adjusting_state state);
@@ -15,6 +15,8 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_WORKSPACE_MANAGER_IMPL_H
 #define HLASMPLUGIN_PARSERLIBRARY_WORKSPACE_MANAGER_IMPL_H
 
+#include <algorithm>
+
 #include "debugging/debug_lib_provider.h"
 #include "debugging/debugger.h"
 #include "workspace_manager.h"
@@ -109,11 +111,18 @@ public:
 
     void did_change_watched_files(std::vector<std::string> paths)
     {
-        for (const auto& path : paths)
+        // the changes are handed to each workspace at once, so that it refreshes and parses only once
+        std::vector<std::pair<workspaces::workspace*, std::vector<std::string>>> changes;
+        for (auto& path : paths)
         {
-            workspaces::workspace& ws = ws_path_match(path);
-            ws.did_change_watched_files(path);
+            workspaces::workspace* ws = &ws_path_match(path);
+            auto found = std::find_if(changes.begin(), changes.end(), [ws](const auto& c) { return c.first == ws; });
+            if (found == changes.end())
+                found = changes.insert(changes.end(), { ws, {} });
+            found->second.push_back(std::move(path));
         }
+        for (const auto& [ws, ws_paths] : changes)
+            ws->did_change_watched_files(ws_paths);
         notify_diagnostics_consumers();
     }
 
@@ -196,7 +205,14 @@ public:
     }
 
     lib_config global_config_;
-    virtual void configuration_changed(const lib_config& new_config) { global_config_ = new_config; }
+    virtual void configuration_changed(const lib_config& new_config)
+    {
+        global_config_ = new_config;
+
+        implicit_workspace_.configuration_changed();
+        for (auto& [name, ws] : workspaces_)
+            ws.configuration_changed();
+    }
 
     std::vector<token_info> empty_tokens;
     const std::vector<token_info>& semantic_tokens(const char* document_uri)
@@ -17,25 +17,149 @@
 
 #include <cerrno>
 #include <codecvt>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <fstream>
 #include <locale>
 #include <string>
 
+#include "lexing/line_table.h"
 
 namespace hlasm_plugin::parser_library::workspaces {
 
+namespace {
+bool utf8_one_byte_begin(char ch)
+{
+    return (ch & 0x80) == 0; // 0xxxxxxx
+}
+
+bool utf8_continue_byte(char ch)
+{
+    return (ch & 0xC0) == 0x80; // 10xxxxxx
+}
+
+
+bool utf8_two_byte_begin(char ch)
+{
+    return (ch & 0xE0) == 0xC0; // 110xxxxx
+}
+
+bool utf8_three_byte_begin(char ch)
+{
+    return (ch & 0xF0) == 0xE0; // 1110xxxx
+}
+
+bool utf8_four_byte_begin(char ch)
+{
+    return (ch & 0xF8) == 0xF0; // 11110xxx
+}
+
+// returns the position of the first character from the position 'from' that is not valid utf-8
+// or the size of the text if there is none
+size_t find_invalid_utf8(const std::string& text, size_t from)
+{
+    // blocks of ascii characters are skipped at once
+    constexpr uint64_t non_ascii_mask = 0x8080808080808080ULL;
+
+    size_t i = from;
+    while (i < text.size())
+    {
+        uint64_t block;
+        while (i + sizeof(block) <= text.size())
+        {
+            std::memcpy(&block, text.data() + i, sizeof(block));
+            if (block & non_ascii_mask)
+                break;
+            i += sizeof(block);
+        }
+        if (i >= text.size())
+            break;
+
+        size_t ch_len = 0;
+        if (utf8_one_byte_begin(text[i]))
+            ch_len = 1;
+        else if (utf8_two_byte_begin(text[i]))
+            ch_len = 2;
+        else if (utf8_three_byte_begin(text[i]))
+            ch_len = 3;
+        else if (utf8_four_byte_begin(text[i]))
+            ch_len = 4;
+        else
+            return i;
+
+        // check whether all subsequent bytes of one character begin with 10
+        for (size_t j = 1; j < ch_len; ++j)
+        {
+            if (i + j >= text.size() || !utf8_continue_byte(text[i + j]))
+                return i; // we consider the first byte of character wrong
+        }
+        i += ch_len;
+    }
+    return text.size();
+}
+} // namespace
+
 file_impl::file_impl(file_uri uri)
     : file_name_(std::move(uri))
     , text_()
 {}
 
+file_impl::file_impl(const file_impl& other)
+    : diagnosable_impl(other)
+    , file_name_(other.file_name_)
+    , text_(other.text_)
+    , lines_ind_(other.lines_ind_)
+    , up_to_date_(other.up_to_date_)
+    , editing_(other.editing_)
+    , bad_(other.bad_)
+    , version_(other.version_)
+{}
+
+file_impl& file_impl::operator=(const file_impl& other)
+{
+    diagnosable_impl::operator=(other);
+    file_name_ = other.file_name_;
+    text_ = other.text_;
+    lines_ind_ = other.lines_ind_;
+    up_to_date_ = other.up_to_date_;
+    editing_ = other.editing_;
+    bad_ = other.bad_;
+    version_ = other.version_;
+    return *this;
+}
+
+file_impl::file_impl(file_impl&& other)
+    : diagnosable_impl(std::move(other))
+    , file_name_(std::move(other.file_name_))
+    , text_(std::move(other.text_))
+    , lines_ind_(std::move(other.lines_ind_))
+    , up_to_date_(other.up_to_date_)
+    , editing_(other.editing_)
+    , bad_(other.bad_)
+    , version_(other.version_)
+{}
+
+file_impl& file_impl::operator=(file_impl&& other)
+{
+    diagnosable_impl::operator=(std::move(other));
+    file_name_ = std::move(other.file_name_);
+    text_ = std::move(other.text_);
+    lines_ind_ = std::move(other.lines_ind_);
+    up_to_date_ = other.up_to_date_;
+    editing_ = other.editing_;
+    bad_ = other.bad_;
+    version_ = other.version_;
+    return *this;
+}
+
 void file_impl::collect_diags() const {}
 
 const file_uri& file_impl::get_file_name() { return file_name_; }
 
 const std::string& file_impl::get_text()
 {
+    std::lock_guard guard(load_mutex_);
     if (!up_to_date_)
         load_text();
     return text_;
@@ -53,7 +177,9 @@ void file_impl::load_text()
         fin.read(&text_[0], text_.size());
         fin.close();
 
-        text_ = replace_non_utf8_chars(text_);
+        // most of the files are valid, they are not copied
+        if (find_invalid_utf8(text_, 0) != text_.size())
+            text_ = replace_non_utf8_chars(text_);
 
         up_to_date_ = true;
         bad_ = false;
@@ -73,37 +199,15 @@ void file_impl::load_text()
 size_t find_newlines(const std::string& text, std::vector<size_t>& lines)
 {
     size_t before = lines.size();
-    bool was_r = false;
-    for (size_t i = 0; i < text.size(); ++i)
+    for (size_t i = lexing::find_line_break(text, 0); i != std::string_view::npos;
+         i = lexing::find_line_break(text, i))
     {
-        char ch = text[i];
-        if (was_r)
-        {
-            if (ch == '\n')
-            {
-                lines.push_back(i + 1);
-                was_r = false;
-            }
-            else if (ch == '\r')
-                lines.push_back(i);
-            else
-            {
-                lines.push_back(i);
-                was_r = false;
-            }
-        }
-        else
-        {
-            if (ch == '\n')
-                lines.push_back(i + 1);
-            else if (ch == '\r')
-                was_r = true;
-        }
+        // "\r\n" is one line break, lone '\r' and '\n' are line breaks too
+        if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n')
+            ++i;
+        lines.push_back(++i);
     }
 
-    if (was_r)
-        lines.push_back(text.size());
-
     return lines.size() - before;
 }
 
@@ -200,36 +304,11 @@ bool file_impl::update_and_get_bad()
     if (editing_)
         return false;
 
+    std::lock_guard guard(load_mutex_);
     load_text();
     return bad_;
 }
 
-bool utf8_one_byte_begin(char ch)
-{
-    return (ch & 0x80) == 0; // 0xxxxxxx
-}
-
-bool utf8_continue_byte(char ch)
-{
-    return (ch & 0xC0) == 0x80; // 10xxxxxx
-}
-
-
-bool utf8_two_byte_begin(char ch)
-{
-    return (ch & 0xE0) == 0xC0; // 110xxxxx
-}
-
-bool utf8_three_byte_begin(char ch)
-{
-    return (ch & 0xF0) == 0xE0; // 1110xxxx
-}
-
-bool utf8_four_byte_begin(char ch)
-{
-    return (ch & 0xF8) == 0xF0; // 11110xxx
-}
-
 // returns the location in text_ that corresponds to utf-16 based location
 size_t file_impl::index_from_location(position loc) const
 {
@@ -280,42 +359,12 @@ std::string file_impl::replace_non_utf8_chars(const std::string& text)
     size_t i = 0;
     while (i < text.size())
     {
-        bool OK = true;
-        size_t ch_len = 0;
-        if (utf8_one_byte_begin(text[i]))
-            ch_len = 1;
-        else if (utf8_two_byte_begin(text[i]))
-            ch_len = 2;
-        else if (utf8_three_byte_begin(text[i]))
-            ch_len = 3;
-        else if (utf8_four_byte_begin(text[i]))
-            ch_len = 4;
-        else
-            OK = false;
-
-        // check whether all subsequent bytes of one character begin with 10
-        if (OK)
-        {
-            for (size_t j = 1; j < ch_len; ++j)
-            {
-                if (i + j >= text.size() || !utf8_continue_byte(text[i + j]))
-                {
-                    OK = false; // we consider the first byte of character wrong
-                    break;
-                }
-            }
-        }
+        // copy the valid characters to output
+        size_t invalid = find_invalid_utf8(text, i);
+        ret.append(text, i, invalid - i);
+        i = invalid;
 
-        if (OK)
-        {
-            // copy the character to output
-            for (size_t j = 0; j < ch_len; ++j)
-            {
-                ret.push_back(text[i + j]);
-            }
-            i += ch_len;
-        }
-        else
+        if (i < text.size())
         {
             // UTF8 replacement for unknown character
             ret.push_back((uint8_t)0xEF);
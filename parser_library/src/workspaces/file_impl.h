@@ -15,6 +15,8 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_FILE_IMPL_H
 #define HLASMPLUGIN_PARSERLIBRARY_FILE_IMPL_H
 
+#include <mutex>
+
 #include "diagnosable_impl.h"
 #include "file.h"
 #include "processor.h"
@@ -30,11 +32,12 @@ class file_impl : public virtual file, public virtual diagnosable_impl
 {
 public:
     explicit file_impl(file_uri uri);
-    explicit file_impl(const file_impl&) = default;
-    file_impl& operator=(const file_impl&) = default;
+    // the loading of the text is not synchronized with the copies
+    explicit file_impl(const file_impl&);
+    file_impl& operator=(const file_impl&);
 
-    file_impl(file_impl&&) = default;
-    file_impl& operator=(file_impl&&) = default;
+    file_impl(file_impl&&);
+    file_impl& operator=(file_impl&&);
 
     virtual void collect_diags() const override;
 
@@ -68,6 +71,9 @@ private:
 
     version_t version_ = 0;
 
+    // a library member may be parsed by several analyses at once, the text is loaded by one of them
+    std::mutex load_mutex_;
+    // expects load_mutex_ to be locked
     void load_text();
 
     size_t index_from_location(position pos) const;
@@ -115,6 +115,7 @@ std::unordered_map<std::string, std::string> file_manager_impl::list_directory_f
         std::filesystem::directory_entry dir(lib_p);
         if (!dir.is_directory())
         {
+            std::lock_guard guard(files_mutex);
             add_diagnostic(diagnostic_s { "",
                 {},
                 "L0001",
@@ -132,6 +133,7 @@ std::unordered_map<std::string, std::string> file_manager_impl::list_directory_f
     }
     catch (const std::filesystem::filesystem_error& e)
     {
+        std::lock_guard guard(files_mutex);
         add_diagnostic(diagnostic_s { path, {}, "L0001", "Unable to load library: " + path + ". Error: " + e.what() });
     }
     return found_files;
@@ -65,6 +65,7 @@ protected:
     std::unordered_map<std::string, std::shared_ptr<file_impl>> files_;
 
 private:
+    // guards the files and the diagnostics, the file manager is used by analyses running in parallel
     std::mutex files_mutex;
 
     std::atomic<bool>* cancel_;
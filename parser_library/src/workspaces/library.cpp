@@ -14,6 +14,8 @@
 
 #include "library.h"
 
+#include <algorithm>
+#include <cwctype>
 #include <filesystem>
 #include <locale>
 #include <regex>
@@ -24,6 +26,30 @@
 
 namespace hlasm_plugin::parser_library::workspaces {
 
+namespace {
+// normal form of a path that can be compared component by component
+std::filesystem::path comparable_path(const std::filesystem::path& p)
+{
+    auto result = p.lexically_normal();
+    // drop the trailing separator of directories
+    if (!result.has_filename() && result.has_relative_path())
+        result = result.parent_path();
+#ifdef _WIN32
+    // paths are case insensitive on windows
+    auto native = result.wstring();
+    std::transform(native.begin(), native.end(), native.begin(), [](wchar_t c) { return (wchar_t)std::towlower(c); });
+    result = native;
+#endif // _WIN32
+    return result;
+}
+
+// whether path is the same as base or lies under it
+bool is_under(const std::filesystem::path& path, const std::filesystem::path& base)
+{
+    return std::mismatch(base.begin(), base.end(), path.begin(), path.end()).first == base.end();
+}
+} // namespace
+
 library_local::library_local(
     file_manager& file_manager, std::string lib_path, std::shared_ptr<const extension_regex_map> extensions)
     : file_manager_(file_manager)
@@ -43,14 +69,61 @@ void library_local::collect_diags() const
 
 void library_local::refresh()
 {
+    std::lock_guard guard(files_mutex_);
     files_.clear();
     load_files();
 }
 
+bool library_local::refresh(const std::string& file_path)
+{
+    auto path = comparable_path(file_path);
+    auto lib_dir = comparable_path(lib_path_);
+    // the directory itself or one of its parents was created or deleted
+    if (!path.empty() && is_under(lib_dir, path))
+    {
+        refresh();
+        return true;
+    }
+    if (path.parent_path() != lib_dir)
+        return false;
+
+    std::lock_guard guard(files_mutex_);
+    // the files will be listed once they are needed
+    if (!files_loaded_)
+        return true;
+
+    // the case of the file name is preserved
+    const std::string file_name = std::filesystem::path(file_path).lexically_normal().filename().string();
+    auto member_name = get_member_name(file_name, file_path);
+    if (file_manager_.file_exists(file_path))
+        files_[member_name] = file_name;
+    else if (auto found = files_.find(member_name);
+             found != files_.end() && std::filesystem::path(found->second).filename() == file_name)
+        files_.erase(found);
+
+    return true;
+}
+
+bool library_local::has_file(const std::string& file_path)
+{
+    auto path = comparable_path(file_path);
+    if (path.parent_path() != comparable_path(lib_path_))
+        return false;
+
+    std::lock_guard guard(files_mutex_);
+    if (!files_loaded_)
+        load_files();
+
+    const std::string file_name = std::filesystem::path(file_path).lexically_normal().filename().string();
+    auto found = files_.find(get_member_name(file_name, file_path));
+    return found != files_.end() && std::filesystem::path(found->second).filename() == file_name;
+}
+
 const std::string& library_local::get_lib_path() const { return lib_path_; }
 
-std::shared_ptr<processor> library_local::find_file(const std::string& file_name)
+processor_file_ptr library_local::find_file(const std::string& file_name)
 {
+    std::lock_guard guard(files_mutex_);
     if (!files_loaded_)
         load_files();
 
@@ -70,26 +143,21 @@ void library_local::load_files()
     auto files_list = file_manager_.list_directory_files(lib_path_);
     files_.clear();
     for (const auto& file : files_list)
-    {
-        bool added = false;
-
-        for (const auto& extension : *extensions_)
-        {
-            // current file matches regex (it has extension)
-            // e.g. file "files/open.hlasm" matches both extensions "files/*.hlasm" and "*.hlasm"
-            if (extension.first.size() < file.second.size() && std::regex_match(file.second, extension.second))
-            {
-                files_[context::to_upper_copy(file.first.substr(0, file.first.size() - extension.first.size()))] =
-                    file.second;
-                added = true;
-                break;
-            }
-        }
-        if (!added)
-            files_[context::to_upper_copy(file.first)] = file.second;
-    }
+        files_[get_member_name(file.first, file.second)] = file.second;
 
     files_loaded_ = true;
 }
 
+std::string library_local::get_member_name(const std::string& file_name, const std::string& file_path) const
+{
+    for (const auto& extension : *extensions_)
+    {
+        // current file matches regex (it has extension)
+        // e.g. file "files/open.hlasm" matches both extensions "files/*.hlasm" and "*.hlasm"
+        if (extension.first.size() < file_path.size() && std::regex_match(file_path, extension.second))
+            return context::to_upper_copy(file_name.substr(0, file_name.size() - extension.first.size()));
+    }
+    return context::to_upper_copy(file_name);
+}
+
 } // namespace hlasm_plugin::parser_library::workspaces
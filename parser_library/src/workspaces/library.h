@@ -15,6 +15,7 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_LIBRARY_H
 #define HLASMPLUGIN_PARSERLIBRARY_LIBRARY_H
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -29,8 +30,13 @@ namespace hlasm_plugin::parser_library::workspaces {
 class library : public virtual diagnosable
 {
 public:
-    virtual std::shared_ptr<processor> find_file(const std::string& file) = 0;
+    virtual processor_file_ptr find_file(const std::string& file) = 0;
     virtual void refresh() = 0;
+    // Updates the library after the file on the path has been created, changed or deleted.
+    // Returns false if the file does not belong to the library.
+    virtual bool refresh(const std::string& file_path) = 0;
+    // Returns true if the file on the path can be found as a member of the library.
+    virtual bool has_file(const std::string& file_path) = 0;
 
 private:
 };
@@ -56,10 +62,13 @@ public:
 
     const std::string& get_lib_path() const;
 
-    virtual std::shared_ptr<processor> find_file(const std::string& file) override;
+    virtual processor_file_ptr find_file(const std::string& file) override;
 
     // this function should be called from workspace, once watchedFilesChanged request is implemented
     virtual void refresh() override;
+    // updates only the entry of the file, the directory is not scanned again
+    virtual bool refresh(const std::string& file_path) override;
+    virtual bool has_file(const std::string& file_path) override;
 
 private:
     file_manager& file_manager_;
@@ -69,8 +78,12 @@ private:
     std::shared_ptr<const extension_regex_map> extensions_;
     // indicates whether load_files function was called (not whether it was succesful)
     bool files_loaded_ = false;
+    // the library is searched by analyses running in parallel
+    std::mutex files_mutex_;
 
     void load_files();
+    // returns the name of the library member stored in the file
+    std::string get_member_name(const std::string& file_name, const std::string& file_path) const;
 };
 #pragma warning(pop)
 
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "macro_cache.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+#include "macro_serializer.h"
+
+namespace hlasm_plugin::parser_library::workspaces {
+
+bool macro_cache_key::operator<(const macro_cache_key& other) const
+{
+    return std::tie(file_name, proc_grp, proc_kind, mnemonics, defer_ca_operands)
+        < std::tie(other.file_name, other.proc_grp, other.proc_kind, other.mnemonics, other.defer_ca_operands);
+}
+
+macro_cache::macro_cache(file_manager& file_mngr)
+    : file_mngr_(file_mngr)
+{}
+
+macro_cache::macro_cache(macro_cache&& other) noexcept
+    : cache_(std::move(other.cache_))
+    , file_mngr_(other.file_mngr_)
+    , storage_directory_(std::move(other.storage_directory_))
+{}
+
+parse_result macro_cache::parse_library(const macro_cache_key& key,
+    processor_file& file,
+    parse_lib_provider& provider,
+    context::hlasm_context& hlasm_ctx,
+    const library_data data)
+{
+    auto entry = get_entry(key);
+    std::lock_guard entry_guard(entry->mutex);
+
+    if (load_from_cache(key, *entry, hlasm_ctx))
+        return true;
+
+    const auto storage_directory = get_storage_directory();
+
+    macro_cache_data cache_data;
+    cache_data.ids = hlasm_ctx.ids_ptr();
+    size_t diags_count = 0;
+
+    if (data.proc_kind == processing::processing_kind::MACRO)
+    {
+        if (load_from_storage(key, *entry, storage_directory, file, hlasm_ctx, data.library_member))
+            return true;
+
+        auto previous = hlasm_ctx.macros().find(data.library_member);
+        context::macro_def_ptr previous_def = previous == hlasm_ctx.macros().end() ? nullptr : previous->second;
+
+        context::lsp_context_snapshot lsp_snapshot(*hlasm_ctx.lsp_ctx);
+        if (!file.parse_macro(provider, hlasm_ctx, data, diags_count))
+            return false;
+
+        auto found = hlasm_ctx.macros().find(data.library_member);
+        if (found == hlasm_ctx.macros().end() || found->second == previous_def)
+            return true;
+
+        cache_data.stamps = create_stamps(key.file_name, &found->second->copy_nests);
+        cache_data.lsp_changes = lsp_snapshot.changes();
+        cache_data.cached_member = found->second;
+        store(key, storage_directory, file, cache_data, diags_count);
+    }
+    else
+    {
+        context::lsp_context_snapshot lsp_snapshot(*hlasm_ctx.lsp_ctx);
+        if (!file.parse_macro(provider, hlasm_ctx, data, diags_count))
+            return false;
+
+        auto found = hlasm_ctx.copy_members().find(data.library_member);
+        if (found == hlasm_ctx.copy_members().end())
+            return true;
+
+        cache_data.stamps = create_stamps(key.file_name, nullptr);
+        cache_data.lsp_changes = lsp_snapshot.changes();
+        cache_data.cached_member = found->second;
+    }
+
+    entry->data = std::move(cache_data);
+    return true;
+}
+
+void macro_cache::set_storage_directory(std::filesystem::path directory)
+{
+    std::lock_guard guard(mutex_);
+    storage_directory_ = std::move(directory);
+}
+
+void macro_cache::invalidate(const std::string& file_name)
+{
+    // the entries are inspected without holding the map, an analysis may hold an entry while it needs another one
+    for (auto& [key, entry] : entries())
+    {
+        bool invalid;
+        {
+            std::lock_guard entry_guard(entry->mutex);
+            invalid = entry->data && entry->data->stamps.find(file_name) != entry->data->stamps.end();
+        }
+        if (!invalid)
+            continue;
+
+        std::lock_guard guard(mutex_);
+        if (auto found = cache_.find(key); found != cache_.end() && found->second == entry)
+            cache_.erase(found);
+    }
+}
+
+void macro_cache::clear()
+{
+    std::lock_guard guard(mutex_);
+    cache_.clear();
+}
+
+size_t macro_cache::size() const
+{
+    size_t result = 0;
+    for (const auto& [key, entry] : entries())
+    {
+        std::lock_guard entry_guard(entry->mutex);
+        result += entry->data.has_value();
+    }
+    return result;
+}
+
+std::vector<std::pair<macro_cache_key, std::shared_ptr<macro_cache_entry>>> macro_cache::entries() const
+{
+    std::lock_guard guard(mutex_);
+    return { cache_.begin(), cache_.end() };
+}
+
+std::shared_ptr<macro_cache_entry> macro_cache::get_entry(const macro_cache_key& key)
+{
+    std::lock_guard guard(mutex_);
+    auto& entry = cache_[key];
+    if (!entry)
+        entry = std::make_shared<macro_cache_entry>();
+    return entry;
+}
+
+std::filesystem::path macro_cache::get_storage_directory() const
+{
+    std::lock_guard guard(mutex_);
+    return storage_directory_;
+}
+
+bool macro_cache::load_from_cache(
+    const macro_cache_key& key, const macro_cache_entry& entry, context::hlasm_context& hlasm_ctx) const
+{
+    if (!entry.data || !is_valid(*entry.data, hlasm_ctx))
+        return false;
+
+    const auto& data = *entry.data;
+
+    // nested COPY members are dependencies of the opencode the same way as when they are parsed
+    for (const auto& [file_name, version] : data.stamps)
+        if (file_name != key.file_name)
+            hlasm_ctx.add_visited_file(file_name);
+
+    if (auto macro = std::get_if<context::macro_def_ptr>(&data.cached_member))
+        hlasm_ctx.add_macro(*macro);
+    else
+        hlasm_ctx.add_copy_member(std::get<context::copy_member_ptr>(data.cached_member));
+
+    context::add_lsp_changes(*hlasm_ctx.lsp_ctx, data.lsp_changes, hlasm_ctx.ids().well_known.empty);
+
+    return true;
+}
+
+bool macro_cache::is_valid(const macro_cache_data& data, context::hlasm_context& hlasm_ctx) const
+{
+    // identifiers in the member are usable only in contexts that share the storage
+    if (data.ids != hlasm_ctx.ids_ptr())
+        return false;
+
+    for (const auto& [file_name, version] : data.stamps)
+    {
+        auto file = file_mngr_.find(file_name);
+        if ((file ? file->get_version() : 0) != version)
+            return false;
+    }
+    return true;
+}
+
+version_stamp macro_cache::create_stamps(const std::string& file_name, const context::copy_nest_storage* nests) const
+{
+    version_stamp stamps;
+
+    auto add_stamp = [this, &stamps](const std::string& name) {
+        if (stamps.find(name) != stamps.end())
+            return;
+        auto file = file_mngr_.find(name);
+        stamps.emplace(name, file ? file->get_version() : 0);
+    };
+
+    add_stamp(file_name);
+    if (nests)
+        for (const auto& nest : *nests)
+            for (const auto& loc : nest)
+                add_stamp(loc.file);
+
+    return stamps;
+}
+
+std::filesystem::path macro_cache::storage_path(
+    const std::filesystem::path& directory, const macro_cache_key& key, const std::string& text)
+{
+    uint64_t hash = stable_hash(std::to_string(macro_format_version));
+    hash = stable_hash(key.file_name, hash);
+    hash = stable_hash(key.mnemonics, hash);
+    hash = stable_hash(key.defer_ca_operands ? "deferred" : "", hash);
+    hash = stable_hash(text, hash);
+
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return directory / name.str();
+}
+
+bool macro_cache::load_from_storage(const macro_cache_key& key,
+    macro_cache_entry& entry,
+    const std::filesystem::path& directory,
+    processor_file& file,
+    context::hlasm_context& hlasm_ctx,
+    context::id_index macro_name)
+{
+    if (directory.empty())
+        return false;
+
+    std::ifstream fin(storage_path(directory, key, file.get_text()), std::ios::in | std::ios::binary);
+    if (!fin)
+        return false;
+    std::string content((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    auto stored = deserialize_macro(content, hlasm_ctx.ids());
+    // the member may define a macro with another name, such definitions are never stored
+    if (!stored || stored->macro->id != macro_name || stored->macro->definition_location.file != key.file_name)
+        return false;
+
+    macro_cache_data cache_data;
+    cache_data.stamps = create_stamps(key.file_name, nullptr);
+    cache_data.ids = hlasm_ctx.ids_ptr();
+    cache_data.cached_member = std::move(stored->macro);
+    cache_data.lsp_changes = std::move(stored->lsp_changes);
+    entry.data = std::move(cache_data);
+
+    return load_from_cache(key, entry, hlasm_ctx);
+}
+
+void macro_cache::store(const macro_cache_key& key,
+    const std::filesystem::path& directory,
+    processor_file& file,
+    const macro_cache_data& data,
+    size_t diags_count) const
+{
+    // definitions with nested COPY members depend on other files,
+    // and diagnostics of members with errors would not be reported after a restart
+    if (directory.empty() || data.stamps.size() != 1 || diags_count != 0)
+        return;
+
+    auto serialized = serialize_macro(*std::get<context::macro_def_ptr>(data.cached_member), data.lsp_changes);
+    if (!serialized)
+        return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec)
+        return;
+
+    // the file is written under a temporary name, so that other processes never read it incomplete
+    auto path = storage_path(directory, key, file.get_text());
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream fout(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        fout.write(serialized->data(), serialized->size());
+        if (!fout)
+            ec = std::make_error_code(std::errc::io_error);
+    }
+    if (!ec)
+        std::filesystem::rename(temp_path, path, ec);
+    if (ec)
+        std::filesystem::remove(temp_path, ec);
+}
+
+} // namespace hlasm_plugin::parser_library::workspaces
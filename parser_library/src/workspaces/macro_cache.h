@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_MACRO_CACHE_H
+#define HLASMPLUGIN_PARSERLIBRARY_MACRO_CACHE_H
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "context/hlasm_context.h"
+#include "file_manager.h"
+#include "parse_lib_provider.h"
+
+namespace hlasm_plugin::parser_library::workspaces {
+
+// Identifies one library member parsed for a processor group in a particular way (as macro or as COPY member).
+struct macro_cache_key
+{
+    std::string file_name;
+    std::string proc_grp;
+    processing::processing_kind proc_kind;
+    // OPSYN changes the way the statements of the member are processed,
+    // so the member is shared only by contexts with the same mnemonics
+    std::string mnemonics;
+    // macros parsed with deferred operands of conditional assembly statements keep them as text
+    bool defer_ca_operands = false;
+
+    bool operator<(const macro_cache_key& other) const;
+};
+
+// Versions of all files that a cached member was created from,
+// that is the member itself and COPY members nested in a macro definition.
+using version_stamp = std::map<std::string, version_t>;
+
+// Parsed library member together with everything needed to register it into another context.
+struct macro_cache_data
+{
+    version_stamp stamps;
+    // storage that the identifiers used in the member point into
+    std::shared_ptr<context::id_storage> ids;
+    std::variant<context::macro_def_ptr, context::copy_member_ptr> cached_member;
+    // LSP information that the parsing of the member added to the context
+    context::lsp_context_delta lsp_changes;
+};
+
+// One member in the cache. The member is parsed by one analysis at a time,
+// other analyses that need it wait for the result.
+struct macro_cache_entry
+{
+    std::recursive_mutex mutex;
+    std::optional<macro_cache_data> data;
+};
+
+// Workspace-wide storage of parsed macro definitions and COPY members.
+// Analyses that share identifier storage take the members from here instead of parsing them again.
+// Each member is locked separately, parsing of a macro definition may need a nested COPY member.
+// Macro definitions can also be stored in a directory, so that they survive a restart.
+class macro_cache
+{
+    std::map<macro_cache_key, std::shared_ptr<macro_cache_entry>> cache_;
+    file_manager& file_mngr_;
+    // guards the map and the storage directory, never held while a member is parsed
+    mutable std::mutex mutex_;
+    // directory of the stored macro definitions, empty when they are not stored
+    std::filesystem::path storage_directory_;
+
+public:
+    explicit macro_cache(file_manager& file_mngr);
+    macro_cache(const macro_cache&) = delete;
+    macro_cache& operator=(const macro_cache&) = delete;
+    // the cache is moved together with its workspace, which happens only before any analysis is started
+    macro_cache(macro_cache&& other) noexcept;
+    macro_cache& operator=(macro_cache&&) = delete;
+
+    // Registers the member into the context. The member is parsed from the file only when
+    // there is no valid cached version of it.
+    parse_result parse_library(const macro_cache_key& key,
+        processor_file& file,
+        parse_lib_provider& provider,
+        context::hlasm_context& hlasm_ctx,
+        const library_data data);
+
+    // Sets the directory where the parsed macro definitions are stored, empty path disables the storing.
+    void set_storage_directory(std::filesystem::path directory);
+
+    // Removes all cached members that were created from the file.
+    void invalidate(const std::string& file_name);
+    void clear();
+
+    size_t size() const;
+
+private:
+    std::shared_ptr<macro_cache_entry> get_entry(const macro_cache_key& key);
+    std::vector<std::pair<macro_cache_key, std::shared_ptr<macro_cache_entry>>> entries() const;
+    std::filesystem::path get_storage_directory() const;
+
+    bool load_from_cache(
+        const macro_cache_key& key, const macro_cache_entry& entry, context::hlasm_context& hlasm_ctx) const;
+    bool is_valid(const macro_cache_data& data, context::hlasm_context& hlasm_ctx) const;
+    version_stamp create_stamps(const std::string& file_name, const context::copy_nest_storage* nests) const;
+
+    // the stored file is identified by the name, the contents and the mnemonics of the member
+    // and by the format version
+    static std::filesystem::path storage_path(
+        const std::filesystem::path& directory, const macro_cache_key& key, const std::string& text);
+    bool load_from_storage(const macro_cache_key& key,
+        macro_cache_entry& entry,
+        const std::filesystem::path& directory,
+        processor_file& file,
+        context::hlasm_context& hlasm_ctx,
+        context::id_index macro_name);
+    void store(const macro_cache_key& key,
+        const std::filesystem::path& directory,
+        processor_file& file,
+        const macro_cache_data& data,
+        size_t diags_count) const;
+};
+
+} // namespace hlasm_plugin::parser_library::workspaces
+
+#endif // !HLASMPLUGIN_PARSERLIBRARY_MACRO_CACHE_H
@@ -0,0 +1,849 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "macro_serializer.h"
+
+#include "processing/statement.h"
+#include "semantics/concatenation_term.h"
+
+namespace hlasm_plugin::parser_library::workspaces {
+
+namespace {
+
+constexpr std::string_view magic = "HLASMMAC";
+// marks a missing point of a concatenation chain
+constexpr uint8_t null_point = 0xFF;
+
+// thrown when the macro cannot be written or its data cannot be read
+struct format_error
+{};
+
+class writer
+{
+    std::string& out_;
+
+public:
+    explicit writer(std::string& out)
+        : out_(out)
+    {}
+
+    void byte(uint8_t value) { out_.push_back((char)value); }
+
+    // variable-length encoding, 7 bits per byte starting with the lowest ones
+    void number(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            byte((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        byte((uint8_t)value);
+    }
+
+    void string(std::string_view value)
+    {
+        number(value.size());
+        out_.append(value);
+    }
+
+    // identifiers may be null
+    void id(context::id_index value)
+    {
+        byte(value != nullptr);
+        if (value)
+            string(*value);
+    }
+
+    void pos(const position& value)
+    {
+        number(value.line);
+        number(value.column);
+    }
+
+    void rng(const range& value)
+    {
+        pos(value.start);
+        pos(value.end);
+    }
+
+    void loc(const location& value)
+    {
+        pos(value.pos);
+        string(value.file);
+    }
+
+    void chain(const semantics::concat_chain& value)
+    {
+        number(value.size());
+        for (const auto& point : value)
+        {
+            if (!point)
+            {
+                byte(null_point);
+                continue;
+            }
+            byte((uint8_t)point->type);
+            switch (point->type)
+            {
+                case semantics::concat_type::STR:
+                    string(point->access_str()->value);
+                    break;
+                case semantics::concat_type::VAR:
+                    var_symbol(*point->access_var()->symbol);
+                    break;
+                case semantics::concat_type::SUB:
+                    number(point->access_sub()->list.size());
+                    for (const auto& item : point->access_sub()->list)
+                        chain(item);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void var_symbol(const semantics::variable_symbol& value)
+    {
+        // subscripts are conditional assembly expressions, they are not described by the format
+        if (!value.subscript.empty())
+            throw format_error();
+
+        byte(value.created);
+        rng(value.symbol_range);
+        if (value.created)
+            chain(value.access_created()->created_name);
+        else
+            id(value.access_basic()->name);
+    }
+
+    void label(const semantics::label_si& value)
+    {
+        byte((uint8_t)value.type);
+        rng(value.field_range);
+        switch (value.type)
+        {
+            case semantics::label_si_type::ORD:
+            case semantics::label_si_type::MAC:
+                string(std::get<std::string>(value.value));
+                break;
+            case semantics::label_si_type::SEQ: {
+                const auto& seq = std::get<semantics::seq_sym>(value.value);
+                id(seq.name);
+                rng(seq.symbol_range);
+                break;
+            }
+            case semantics::label_si_type::VAR:
+                var_symbol(*std::get<semantics::vs_ptr>(value.value));
+                break;
+            case semantics::label_si_type::CONC:
+                chain(std::get<semantics::concat_chain>(value.value));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void instruction(const semantics::instruction_si& value)
+    {
+        byte((uint8_t)value.type);
+        rng(value.field_range);
+        if (value.type == semantics::instruction_si_type::ORD)
+            id(std::get<context::id_index>(value.value));
+        else if (value.type == semantics::instruction_si_type::CONC)
+            chain(std::get<semantics::concat_chain>(value.value));
+    }
+
+    void statement(const context::hlasm_statement& value)
+    {
+        if (auto deferred = dynamic_cast<const semantics::statement_si_deferred*>(&value))
+        {
+            byte((uint8_t)context::statement_kind::DEFERRED);
+            rng(deferred->stmt_range);
+            label(deferred->label);
+            instruction(deferred->instruction);
+            string(deferred->deferred_field);
+            rng(deferred->deferred_range);
+            return;
+        }
+
+        // resolved statements of macro definitions are conditional assembly instructions without operands
+        auto resolved = dynamic_cast<const processing::resolved_statement_impl*>(&value);
+        if (!resolved || !std::holds_alternative<semantics::statement_si>(resolved->value))
+            throw format_error();
+
+        byte((uint8_t)context::statement_kind::RESOLVED);
+        rng(resolved->stmt_range_ref());
+        label(resolved->label_ref());
+        instruction(resolved->instruction_ref());
+
+        const auto& operands = resolved->operands_ref();
+        rng(operands.field_range);
+        number(operands.value.size());
+        for (const auto& op : operands.value)
+        {
+            if (op && op->type != semantics::operand_type::EMPTY)
+                throw format_error();
+            byte(op != nullptr);
+            if (op)
+                rng(op->operand_range);
+        }
+
+        const auto& remarks = resolved->remarks_ref();
+        rng(remarks.field_range);
+        number(remarks.value.size());
+        for (const auto& r : remarks.value)
+            rng(r);
+
+        id(resolved->opcode.value);
+        byte((uint8_t)resolved->opcode.type);
+        byte((uint8_t)resolved->format.kind);
+        byte((uint8_t)resolved->format.form);
+        byte((uint8_t)resolved->format.occurence);
+    }
+
+    void param_data(const context::macro_param_data_component& value)
+    {
+        if (dynamic_cast<const context::macro_param_data_dummy*>(&value))
+            byte(0);
+        else if (dynamic_cast<const context::macro_param_data_single*>(&value))
+        {
+            byte(1);
+            string(value.get_value());
+        }
+        else
+        {
+            byte(2);
+            number(value.size());
+            for (size_t i = 0; i < value.size(); ++i)
+                param_data(*value.get_ith(i));
+        }
+    }
+
+    void macro(const context::macro_definition& value)
+    {
+        id(value.id);
+
+        // the first positional parameter is the label parameter
+        const auto& positional = value.positional_params();
+        id(positional.front() ? positional.front()->id : nullptr);
+        number(positional.size() - 1);
+        for (size_t i = 1; i < positional.size(); ++i)
+            id(positional[i] ? positional[i]->id : nullptr);
+
+        number(value.keyword_params().size());
+        for (const auto& param : value.keyword_params())
+        {
+            id(param->id);
+            param_data(*param->default_data);
+        }
+
+        number(value.cached_definition.size());
+        for (const auto& stmt : value.cached_definition)
+            statement(*stmt.get_base());
+
+        number(value.copy_nests.size());
+        for (const auto& nest : value.copy_nests)
+        {
+            number(nest.size());
+            for (const auto& l : nest)
+                loc(l);
+        }
+
+        number(value.labels.size());
+        for (const auto& [name, symbol] : value.labels)
+        {
+            auto macro_symbol = symbol->access_macro_symbol();
+            if (!macro_symbol)
+                throw format_error();
+            id(macro_symbol->name);
+            loc(macro_symbol->symbol_location);
+            number(macro_symbol->statement_offset);
+        }
+
+        loc(value.definition_location);
+    }
+
+    // file names are not identifiers, they keep their case
+    void file_name(const std::string* value)
+    {
+        byte(value != nullptr);
+        if (value)
+            string(*value);
+    }
+
+    void occurences(const std::vector<context::occurence>& value)
+    {
+        number(value.size());
+        for (const auto& occ : value)
+        {
+            rng(occ.symbol_range);
+            file_name(occ.file_name);
+        }
+    }
+
+    void definition(const context::definition& value)
+    {
+        id(value.name);
+        file_name(value.file_name);
+        rng(value.definition_range);
+    }
+
+    void scope(const context::macro_id& value)
+    {
+        id(value.name);
+        number(value.version);
+    }
+
+    void item(const context::completion_item_s& value)
+    {
+        string(value.label);
+        string(value.detail);
+        string(value.insert_text);
+        auto contents = value.get_contents();
+        number(contents.size());
+        for (const auto& line : contents)
+            string(line);
+        number(value.kind);
+    }
+
+    void instruction(const context::instr_definition& value)
+    {
+        definition(value);
+        number(value.version);
+        byte(value.item.has_value());
+        if (value.item)
+            item(*value.item);
+    }
+
+    void instructions(const context::lsp_context_delta::entries<context::instr_definition>& value)
+    {
+        number(value.size());
+        for (const auto& [symbol, occs] : value)
+        {
+            instruction(symbol);
+            occurences(occs);
+        }
+    }
+
+    void lsp_changes(const context::lsp_context_delta& value)
+    {
+        number(value.seq_symbols.size());
+        for (const auto& [symbol, occs] : value.seq_symbols)
+        {
+            definition(symbol);
+            scope(symbol.scope);
+            occurences(occs);
+        }
+
+        number(value.var_symbols.size());
+        for (const auto& [symbol, occs] : value.var_symbols)
+        {
+            definition(symbol);
+            byte((uint8_t)symbol.type);
+            scope(symbol.scope);
+            occurences(occs);
+        }
+
+        // values of ordinary symbols are not described by the format
+        number(value.ord_symbols.size());
+        for (const auto& [symbol, occs] : value.ord_symbols)
+        {
+            if (symbol.val.value_kind() != context::symbol_value_kind::UNDEF || symbol.attr)
+                throw format_error();
+            definition(symbol);
+            occurences(occs);
+        }
+
+        instructions(value.defined_instructions);
+        instructions(value.used_instructions);
+
+        number(value.all_instructions.size());
+        for (const auto& i : value.all_instructions)
+            item(i);
+
+        byte(value.deferred_macro_statement.has_value());
+        if (value.deferred_macro_statement)
+            definition(*value.deferred_macro_statement);
+    }
+};
+
+// all reads check the bounds of the data
+class reader
+{
+    std::string_view data_;
+    context::id_storage& ids_;
+
+public:
+    reader(std::string_view data, context::id_storage& ids)
+        : data_(data)
+        , ids_(ids)
+    {}
+
+    bool finished() const { return data_.empty(); }
+
+    uint8_t byte()
+    {
+        if (data_.empty())
+            throw format_error();
+        auto result = (uint8_t)data_.front();
+        data_.remove_prefix(1);
+        return result;
+    }
+
+    // enumeration value that must not exceed the last enumerator
+    template<typename T>
+    T enumeration(T last)
+    {
+        auto value = byte();
+        if (value > (uint8_t)last)
+            throw format_error();
+        return (T)value;
+    }
+
+    uint64_t number()
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            auto b = byte();
+            result |= (uint64_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return result;
+        }
+        throw format_error();
+    }
+
+    // number of items that follow, each of them takes at least one byte
+    size_t count()
+    {
+        auto result = number();
+        if (result > data_.size())
+            throw format_error();
+        return (size_t)result;
+    }
+
+    std::string_view raw(size_t size)
+    {
+        if (size > data_.size())
+            throw format_error();
+        auto result = data_.substr(0, size);
+        data_.remove_prefix(size);
+        return result;
+    }
+
+    std::string string() { return std::string(raw(count())); }
+
+    context::id_index id()
+    {
+        if (!byte())
+            return nullptr;
+        // identifiers are stored in their final form, they are not upper-cased again
+        return ids_.add(string(), true);
+    }
+
+    position pos()
+    {
+        auto line = number();
+        auto column = number();
+        return position(line, column);
+    }
+
+    range rng()
+    {
+        auto start = pos();
+        auto end = pos();
+        return range(start, end);
+    }
+
+    location loc()
+    {
+        auto p = pos();
+        return location(p, string());
+    }
+
+    semantics::concat_chain chain()
+    {
+        semantics::concat_chain result;
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto type = byte();
+            if (type == null_point)
+            {
+                result.push_back(nullptr);
+                continue;
+            }
+            switch ((semantics::concat_type)type)
+            {
+                case semantics::concat_type::STR:
+                    result.push_back(std::make_unique<semantics::char_str_conc>(string()));
+                    break;
+                case semantics::concat_type::VAR:
+                    result.push_back(std::make_unique<semantics::var_sym_conc>(var_symbol()));
+                    break;
+                case semantics::concat_type::DOT:
+                    result.push_back(std::make_unique<semantics::dot_conc>());
+                    break;
+                case semantics::concat_type::EQU:
+                    result.push_back(std::make_unique<semantics::equals_conc>());
+                    break;
+                case semantics::concat_type::SUB: {
+                    std::vector<semantics::concat_chain> list;
+                    for (size_t j = count(); j > 0; --j)
+                        list.push_back(chain());
+                    result.push_back(std::make_unique<semantics::sublist_conc>(std::move(list)));
+                    break;
+                }
+                default:
+                    throw format_error();
+            }
+        }
+        return result;
+    }
+
+    semantics::vs_ptr var_symbol()
+    {
+        bool created = byte();
+        auto r = rng();
+        if (created)
+            return std::make_unique<semantics::created_variable_symbol>(
+                chain(), std::vector<expressions::ca_expr_ptr>(), r);
+
+        auto name = id();
+        if (!name)
+            throw format_error();
+        return std::make_unique<semantics::basic_variable_symbol>(name, std::vector<expressions::ca_expr_ptr>(), r);
+    }
+
+    semantics::label_si label()
+    {
+        auto type = enumeration(semantics::label_si_type::EMPTY);
+        auto r = rng();
+        switch (type)
+        {
+            case semantics::label_si_type::ORD:
+                return semantics::label_si(r, string());
+            case semantics::label_si_type::MAC:
+                return semantics::label_si(r, string(), semantics::label_si::mac_flag());
+            case semantics::label_si_type::SEQ: {
+                auto name = id();
+                auto symbol_range = rng();
+                return semantics::label_si(r, semantics::seq_sym { name, symbol_range });
+            }
+            case semantics::label_si_type::VAR:
+                return semantics::label_si(r, var_symbol());
+            case semantics::label_si_type::CONC:
+                return semantics::label_si(r, chain());
+            default:
+                return semantics::label_si(r);
+        }
+    }
+
+    semantics::instruction_si instruction()
+    {
+        auto type = enumeration(semantics::instruction_si_type::EMPTY);
+        auto r = rng();
+        switch (type)
+        {
+            case semantics::instruction_si_type::ORD:
+                return semantics::instruction_si(r, id());
+            case semantics::instruction_si_type::CONC:
+                return semantics::instruction_si(r, chain());
+            default:
+                return semantics::instruction_si(r);
+        }
+    }
+
+    context::shared_stmt_ptr statement()
+    {
+        auto kind = enumeration(context::statement_kind::DEFERRED);
+        auto stmt_range = rng();
+        auto stmt_label = label();
+        auto stmt_instruction = instruction();
+
+        if (kind == context::statement_kind::DEFERRED)
+        {
+            auto field = string();
+            auto field_range = rng();
+            return std::make_shared<semantics::statement_si_deferred>(
+                stmt_range, std::move(stmt_label), std::move(stmt_instruction), std::move(field), field_range);
+        }
+
+        auto operands_range = rng();
+        semantics::operand_list operands;
+        for (size_t i = count(); i > 0; --i)
+        {
+            if (byte())
+                operands.push_back(std::make_unique<semantics::empty_operand>(rng()));
+            else
+                operands.push_back(nullptr);
+        }
+
+        auto remarks_range = rng();
+        std::vector<range> remarks;
+        for (size_t i = count(); i > 0; --i)
+            remarks.push_back(rng());
+
+        auto opcode_value = id();
+        auto opcode_type = enumeration(context::instruction_type::UNDEF);
+        auto format_kind = enumeration(processing::processing_kind::COPY);
+        auto format_form = enumeration(processing::processing_form::UNKNOWN);
+        auto format_occurence = enumeration(processing::operand_occurence::ABSENT);
+
+        return std::make_shared<processing::resolved_statement_impl>(
+            semantics::statement_si(stmt_range,
+                std::move(stmt_label),
+                std::move(stmt_instruction),
+                semantics::operands_si(operands_range, std::move(operands)),
+                semantics::remarks_si(remarks_range, std::move(remarks))),
+            processing::op_code(opcode_value, opcode_type),
+            processing::processing_format(format_kind, format_form, format_occurence));
+    }
+
+    context::macro_data_ptr param_data()
+    {
+        switch (byte())
+        {
+            case 0:
+                return std::make_unique<context::macro_param_data_dummy>();
+            case 1:
+                return std::make_unique<context::macro_param_data_single>(string());
+            case 2: {
+                std::vector<context::macro_data_ptr> items;
+                for (size_t i = count(); i > 0; --i)
+                    items.push_back(param_data());
+                return std::make_unique<context::macro_param_data_composite>(std::move(items));
+            }
+            default:
+                throw format_error();
+        }
+    }
+
+    context::macro_def_ptr macro()
+    {
+        auto name = id();
+        auto label_param_name = id();
+        if (!name)
+            throw format_error();
+
+        // positional parameters are followed by the keyword ones, their positions stay the same
+        std::vector<context::macro_arg> params;
+        for (size_t i = count(); i > 0; --i)
+            params.emplace_back(nullptr, id());
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto param_name = id();
+            if (!param_name)
+                throw format_error();
+            params.emplace_back(param_data(), param_name);
+        }
+
+        context::statement_block definition;
+        for (size_t i = count(); i > 0; --i)
+            definition.push_back(statement());
+
+        context::copy_nest_storage copy_nests;
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto& nest = copy_nests.emplace_back();
+            for (size_t j = count(); j > 0; --j)
+                nest.push_back(loc());
+        }
+
+        context::label_storage labels;
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto symbol_name = id();
+            auto symbol_location = loc();
+            auto offset = number();
+            labels.emplace(
+                symbol_name, std::make_unique<context::macro_sequence_symbol>(symbol_name, symbol_location, offset));
+        }
+
+        auto definition_location = loc();
+
+        return std::make_shared<context::macro_definition>(name,
+            label_param_name,
+            std::move(params),
+            std::move(definition),
+            std::move(copy_nests),
+            std::move(labels),
+            std::move(definition_location),
+            ids_);
+    }
+
+    const std::string* file_name()
+    {
+        if (!byte())
+            return nullptr;
+        return ids_.add(string(), true);
+    }
+
+    std::vector<context::occurence> occurences()
+    {
+        std::vector<context::occurence> result;
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto occ_range = rng();
+            result.emplace_back(occ_range, file_name());
+        }
+        return result;
+    }
+
+    context::definition definition()
+    {
+        auto name = id();
+        auto file = file_name();
+        auto definition_range = rng();
+        return context::definition(name, file, definition_range);
+    }
+
+    context::macro_id scope()
+    {
+        auto name = id();
+        auto version = number();
+        return { name, (size_t)version };
+    }
+
+    context::completion_item_s item()
+    {
+        auto label = string();
+        auto detail = string();
+        auto insert_text = string();
+        std::vector<std::string> contents;
+        for (size_t i = count(); i > 0; --i)
+            contents.push_back(string());
+        auto kind = number();
+        return context::completion_item_s(
+            std::move(label), std::move(detail), std::move(insert_text), std::move(contents), kind);
+    }
+
+    context::lsp_context_delta::entries<context::instr_definition> instructions()
+    {
+        context::lsp_context_delta::entries<context::instr_definition> result;
+        for (size_t i = count(); i > 0; --i)
+        {
+            context::instr_definition symbol;
+            auto def = definition();
+            symbol.init(def.file_name, def.name, def.definition_range);
+            symbol.version = (size_t)number();
+            if (byte())
+                symbol.item = item();
+            result.emplace_back(std::move(symbol), occurences());
+        }
+        return result;
+    }
+
+    context::lsp_context_delta lsp_changes()
+    {
+        context::lsp_context_delta result;
+
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto def = definition();
+            auto symbol_scope = scope();
+            result.seq_symbols.emplace_back(
+                context::seq_definition(def.name, def.file_name, def.definition_range, symbol_scope), occurences());
+        }
+
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto def = definition();
+            auto type = enumeration(context::var_type::MACRO);
+            auto symbol_scope = scope();
+            result.var_symbols.emplace_back(
+                context::var_definition(def.name, def.file_name, def.definition_range, type, symbol_scope),
+                occurences());
+        }
+
+        for (size_t i = count(); i > 0; --i)
+        {
+            auto def = definition();
+            result.ord_symbols.emplace_back(
+                context::ord_definition(def.name, def.file_name, def.definition_range), occurences());
+        }
+
+        result.defined_instructions = instructions();
+        result.used_instructions = instructions();
+
+        for (size_t i = count(); i > 0; --i)
+            result.all_instructions.push_back(item());
+
+        if (byte())
+        {
+            auto def = definition();
+            result.deferred_macro_statement.emplace();
+            result.deferred_macro_statement->init(def.file_name, def.name, def.definition_range);
+        }
+
+        return result;
+    }
+};
+
+} // namespace
+
+std::optional<std::string> serialize_macro(
+    const context::macro_definition& macro, const context::lsp_context_delta& lsp_changes)
+{
+    std::string result(magic);
+    writer w(result);
+    w.number(macro_format_version);
+    try
+    {
+        w.macro(macro);
+        w.lsp_changes(lsp_changes);
+    }
+    catch (const format_error&)
+    {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::optional<serialized_macro> deserialize_macro(std::string_view data, context::id_storage& ids)
+{
+    if (data.substr(0, magic.size()) != magic)
+        return std::nullopt;
+
+    reader r(data.substr(magic.size()), ids);
+    try
+    {
+        if (r.number() != macro_format_version)
+            return std::nullopt;
+
+        serialized_macro result;
+        result.macro = r.macro();
+        result.lsp_changes = r.lsp_changes();
+        if (!r.finished())
+            return std::nullopt;
+        return result;
+    }
+    catch (const format_error&)
+    {
+        return std::nullopt;
+    }
+}
+
+uint64_t stable_hash(std::string_view text, uint64_t seed)
+{
+    // FNV-1a
+    uint64_t result = seed;
+    for (char c : text)
+    {
+        result ^= (uint8_t)c;
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
+
+} // namespace hlasm_plugin::parser_library::workspaces
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#ifndef HLASMPLUGIN_PARSERLIBRARY_MACRO_SERIALIZER_H
+#define HLASMPLUGIN_PARSERLIBRARY_MACRO_SERIALIZER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "context/lsp_context.h"
+#include "context/macro.h"
+
+namespace hlasm_plugin::parser_library::workspaces {
+
+// version of the binary format, it must be increased whenever the format or the representation
+// of parsed statements changes, so that the data stored by older versions are not used
+constexpr uint32_t macro_format_version = 2;
+
+// macro definition together with the LSP information of its file
+struct serialized_macro
+{
+    context::macro_def_ptr macro;
+    context::lsp_context_delta lsp_changes;
+};
+
+// Creates the binary form of the parsed macro definition: the prototype, the statements, the copy nests,
+// the sequence symbols and the location of the definition.
+// Returns nullopt when the definition contains statements that the format does not describe
+// (resolved statements with operands, subscripted variable symbols, values of ordinary symbols, ...).
+std::optional<std::string> serialize_macro(
+    const context::macro_definition& macro, const context::lsp_context_delta& lsp_changes);
+
+// Recreates the macro definition from its binary form, identifiers are added to the storage.
+// Returns nullopt when the data are damaged or were created by another version of the format.
+std::optional<serialized_macro> deserialize_macro(std::string_view data, context::id_storage& ids);
+
+// Hash of the text that stays the same across runs of the program.
+uint64_t stable_hash(std::string_view text, uint64_t seed = 14695981039346656037ULL);
+
+} // namespace hlasm_plugin::parser_library::workspaces
+
+#endif // !HLASMPLUGIN_PARSERLIBRARY_MACRO_SERIALIZER_H
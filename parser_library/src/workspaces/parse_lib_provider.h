@@ -25,6 +25,8 @@ struct library_data
 {
     processing::processing_kind proc_kind;
     context::id_index library_member;
+    // operands of conditional assembly statements in macro definitions are parsed when they are executed
+    bool defer_ca_operands = false;
 };
 // Interface that the analyzer uses to parse macros and COPY files in separate files (libraries).
 class parse_lib_provider
@@ -37,6 +39,10 @@ public:
 
     virtual bool has_library(const std::string& library, context::hlasm_context& hlasm_ctx) const = 0;
 
+    // Returns identifier storage that should be shared by all analyses using this provider,
+    // so that library members parsed once can be reused by them. Empty pointer if there is none.
+    virtual std::shared_ptr<context::id_storage> get_id_storage() const { return nullptr; }
+
     virtual ~parse_lib_provider() = default;
 };
 
@@ -35,7 +35,10 @@ public:
     // starts parser with new (empty) context
     virtual parse_result parse(parse_lib_provider&) = 0;
     // starts parser with in the context of parameter
-    virtual parse_result parse_macro(parse_lib_provider&, context::hlasm_context&, const library_data) = 0;
+    // the number of diagnostics of this analysis is stored to diags_count, as the diagnostics of the processor
+    // may be replaced by another analysis of the same file running in parallel
+    virtual parse_result parse_macro(
+        parse_lib_provider&, context::hlasm_context&, const library_data, size_t& diags_count) = 0;
     // starts parser to parse macro but does not update parse info or diagnostics
     virtual parse_result parse_no_lsp_update(parse_lib_provider&, context::hlasm_context&, const library_data) = 0;
 };
@@ -42,16 +42,17 @@ bool processor_file_impl::is_once_only() const { return false; }
 
 parse_result processor_file_impl::parse(parse_lib_provider& lib_provider)
 {
-    analyzer_ = std::make_unique<analyzer>(get_text(), get_file_name(), lib_provider, nullptr, get_lsp_editing());
+    auto new_analyzer =
+        std::make_unique<analyzer>(get_text(), get_file_name(), lib_provider, nullptr, get_lsp_editing());
+    new_analyzer->analyze(cancel_);
 
+    std::lock_guard guard(results_mutex_);
     auto old_dep = dependencies_;
 
-    auto res = parse_inner(*analyzer_);
-
     if (!cancel_ || !*cancel_)
     {
         dependencies_.clear();
-        for (auto& file : analyzer_->context().get_visited_files())
+        for (auto& file : new_analyzer->context().get_visited_files())
             if (file != get_file_name())
                 dependencies_.insert(file);
     }
@@ -64,17 +65,21 @@ parse_result processor_file_impl::parse(parse_lib_provider& lib_provider)
             files_to_close_.insert(file);
     }
 
-    return res;
+    return update_results(std::move(new_analyzer));
 }
 
 
 parse_result processor_file_impl::parse_macro(
-    parse_lib_provider& lib_provider, context::hlasm_context& hlasm_ctx, const library_data data)
+    parse_lib_provider& lib_provider, context::hlasm_context& hlasm_ctx, const library_data data, size_t& diags_count)
 {
-    analyzer_ =
+    auto new_analyzer =
         std::make_unique<analyzer>(get_text(), get_file_name(), hlasm_ctx, lib_provider, data, get_lsp_editing());
+    new_analyzer->analyze(cancel_);
 
-    return parse_inner(*analyzer_);
+    std::lock_guard guard(results_mutex_);
+    auto result = update_results(std::move(new_analyzer));
+    diags_count = diags().size();
+    return result;
 }
 
 parse_result processor_file_impl::parse_no_lsp_update(
@@ -101,13 +106,11 @@ const std::set<std::string>& processor_file_impl::files_to_close() { return file
 
 const performance_metrics& processor_file_impl::get_metrics() { return analyzer_->get_metrics(); }
 
-bool processor_file_impl::parse_inner(analyzer& new_analyzer)
+bool processor_file_impl::update_results(std::unique_ptr<analyzer> new_analyzer)
 {
     diags().clear();
-
-    new_analyzer.analyze(cancel_);
-
-    collect_diags_from_child(new_analyzer);
+    collect_diags_from_child(*new_analyzer);
+    analyzer_ = std::move(new_analyzer);
 
     // collect semantic info if the file is open in IDE
     if (get_lsp_editing())
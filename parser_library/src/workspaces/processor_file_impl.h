@@ -15,6 +15,8 @@
 #ifndef HLASMPLUGIN_PARSERLIBRARY_PROCESSOR_FILE_H
 #define HLASMPLUGIN_PARSERLIBRARY_PROCESSOR_FILE_H
 
+#include <mutex>
+
 #include "analyzer.h"
 #include "file_impl.h"
 #include "processor.h"
@@ -35,7 +37,8 @@ public:
     // Starts parser with new (empty) context
     virtual parse_result parse(parse_lib_provider&) override;
     // Starts parser with in the context of parameter
-    virtual parse_result parse_macro(parse_lib_provider&, context::hlasm_context&, const library_data) override;
+    virtual parse_result parse_macro(
+        parse_lib_provider&, context::hlasm_context&, const library_data, size_t& diags_count) override;
     // Starts parser with in the context of parameter, but does not affect LSP, HL info or parse_info_updated.
     // Used by the macro tracer.
     virtual parse_result parse_no_lsp_update(parse_lib_provider&, context::hlasm_context&, const library_data) override;
@@ -52,8 +55,12 @@ public:
 
 private:
     std::unique_ptr<analyzer> analyzer_;
+    // the file may be analyzed by several analyses at once when it is used as a library by more programs,
+    // the results of the analysis that finishes last are kept
+    std::mutex results_mutex_;
 
-    bool parse_inner(analyzer&);
+    // replaces the results of the previous analysis, expects results_mutex_ to be locked
+    bool update_results(std::unique_ptr<analyzer> new_analyzer);
 
     bool parse_info_updated_ = false;
     std::atomic<bool>* cancel_;
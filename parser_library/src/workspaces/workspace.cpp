@@ -14,9 +14,11 @@
 
 #include "workspace.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <regex>
 #include <string>
+#include <thread>
 
 #include "lib_config.h"
 #include "processor.h"
@@ -26,6 +28,11 @@ using json = nlohmann::json;
 
 namespace hlasm_plugin::parser_library::workspaces {
 
+namespace {
+// number of identifiers after which the shared storage is replaced, so that it does not grow indefinitely
+constexpr size_t id_storage_limit = 1000000;
+} // namespace
+
 workspace::workspace(const ws_uri& uri,
     const std::string& name,
     file_manager& file_manager,
@@ -37,6 +44,8 @@ workspace::workspace(const ws_uri& uri,
     , file_manager_(file_manager)
     , implicit_proc_grp("pg_implicit")
     , ws_path_(uri)
+    , ids_(std::make_shared<context::id_storage>())
+    , macro_cache_(file_manager)
     , global_config_(global_config)
 {
     proc_grps_path_ = ws_path_ / HLASM_PLUGIN_FOLDER / FILENAME_PROC_GRPS;
@@ -98,7 +107,43 @@ void workspace::show_message(const std::string& message)
 
 lib_config workspace::get_config() { return local_config_.fill_missing_settings(global_config_); }
 
+void workspace::configuration_changed() { apply_config_(); }
+
+void workspace::apply_config_()
+{
+    auto config = get_config();
+    macro_cache_.set_storage_directory(*config.persistent_macro_cache
+            ? ws_path_ / HLASM_PLUGIN_FOLDER / MACRO_CACHE_FOLDER
+            : std::filesystem::path());
+    defer_macro_ca_operands_ = *config.defer_macro_ca_operands;
+}
+
 const processor_group& workspace::get_proc_grp_by_program(const std::string& filename) const
+{
+    return get_cached_proc_grp_(filename).first;
+}
+
+std::pair<const processor_group&, bool> workspace::get_cached_proc_grp_(const std::string& filename) const
+{
+    std::lock_guard guard(proc_grp_cache_.mutex);
+    auto found = proc_grp_cache_.groups.find(filename);
+    if (found != proc_grp_cache_.groups.end())
+        return { *found->second, true };
+
+    const processor_group& grp = find_proc_grp_by_program_(filename);
+    proc_grp_cache_.groups.emplace(filename, &grp);
+    return { grp, false };
+}
+
+const processor_group& workspace::get_proc_grp_by_program_(context::hlasm_context& hlasm_ctx) const
+{
+    auto [grp, cached] = get_cached_proc_grp_(hlasm_ctx.opencode_file_name());
+    if (cached)
+        ++hlasm_ctx.metrics.proc_grp_cache_hits;
+    return grp;
+}
+
+const processor_group& workspace::find_proc_grp_by_program_(const std::string& filename) const
 {
     assert(opened_);
 
@@ -122,43 +167,47 @@ const ws_uri& workspace::uri() { return uri_; }
 
 void workspace::parse_file(const std::string& file_uri)
 {
+    start_id_generation_(false);
+
     std::filesystem::path file_path(file_uri);
     // add support for hlasm to vscode (auto detection??) and do the decision based on languageid
     if (file_path == proc_grps_path_ || file_path == pgm_conf_path_)
     {
         if (load_and_process_config())
         {
+            std::vector<processor_file_ptr> files_to_parse;
             for (auto fname : dependants_)
             {
                 auto found = file_manager_.find_processor_file(fname);
                 if (found)
-                    found->parse(*this);
+                    files_to_parse.push_back(found);
             }
 
-            for (auto fname : dependants_)
-            {
-                auto found = file_manager_.find_processor_file(fname);
-                if (found)
-                    filter_and_close_dependencies_(found->files_to_close(), found);
-            }
+            parse_dependants_in_parallel(files_to_parse);
+            for (auto f : files_to_parse)
+                update_dependants_index_(f);
+
+            for (auto f : files_to_parse)
+                filter_and_close_dependencies_(f->files_to_close(), f);
         }
         return;
     }
+
+    parse_files_(find_files_to_parse_(file_uri));
+}
+
+std::vector<processor_file_ptr> workspace::find_files_to_parse_(const std::string& file_uri)
+{
     // what about removing files??? what if depentands_ points to not existing file?
     std::vector<processor_file_ptr> files_to_parse;
 
-    for (auto fname : dependants_)
+    if (auto dependants = dependants_index_.find(file_uri); dependants != dependants_index_.end())
     {
-        auto f = file_manager_.find_processor_file(fname);
-        if (!f)
-            continue;
-        for (auto& name : f->dependencies())
+        for (const auto& fname : dependants->second)
         {
-            if (name == file_uri)
-            {
+            auto f = file_manager_.find_processor_file(fname);
+            if (f)
                 files_to_parse.push_back(f);
-                break;
-            }
         }
     }
 
@@ -169,11 +218,17 @@ void workspace::parse_file(const std::string& file_uri)
             files_to_parse.push_back(f);
     }
 
+    return files_to_parse;
+}
+
+void workspace::parse_files_(const std::vector<processor_file_ptr>& files_to_parse)
+{
     for (auto f : files_to_parse)
     {
         f->parse(*this);
         if (!f->dependencies().empty())
             dependants_.insert(f->get_file_name());
+        update_dependants_index_(f);
 
 
         // if there is no processor group assigned to the program, delete diagnostics that may have been created
@@ -193,13 +248,47 @@ void workspace::parse_file(const std::string& file_uri)
         filter_and_close_dependencies_(f->files_to_close(), f);
 }
 
-void workspace::refresh_libraries()
+void workspace::parse_dependants_in_parallel(const std::vector<processor_file_ptr>& files)
+{
+    // a file that is used as a library by another dependant is parsed on this thread after all the others are done,
+    // so that its results do not depend on the order of the analyses. The dependencies known from the last parsing
+    // are not enough, the file may have become a library member under the new configuration.
+    std::vector<processor_file_ptr> independent;
+    std::vector<processor_file_ptr> dependent;
+    for (const auto& f : files)
+    {
+        if (!is_dependency_(f->get_file_name()) && !is_library_member_(f->get_file_name()))
+            independent.push_back(f);
+        else
+            dependent.push_back(f);
+    }
+
+    size_t workers_count = std::min((size_t)*get_config().parallel_analysis_workers, independent.size());
+    std::atomic<size_t> next_file = 0;
+    auto worker = [this, &independent, &next_file]() {
+        for (size_t i = next_file++; i < independent.size(); i = next_file++)
+            independent[i]->parse(*this);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workers_count; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers)
+        t.join();
+
+    for (const auto& f : dependent)
+        f->parse(*this);
+}
+
+void workspace::refresh_libraries(const std::vector<std::string>& file_uris)
 {
     for (auto& proc_grp : proc_grps_)
     {
         for (auto& lib : proc_grp.second.libraries())
         {
-            lib->refresh();
+            for (const auto& file_uri : file_uris)
+                lib->refresh(file_uri);
         }
     }
 }
@@ -225,6 +314,8 @@ void workspace::did_close_file(const std::string& file_uri)
         // filter the dependencies that should not be closed
         filter_and_close_dependencies_(file->dependencies(), file);
         // remove it from dependants
+        for (const auto& dependency : file->dependencies())
+            remove_from_dependants_index_(dependency, file_uri);
         dependants_.erase(fname);
     }
 
@@ -233,14 +324,40 @@ void workspace::did_close_file(const std::string& file_uri)
     file_manager_.remove_file(file_uri);
 }
 
-void workspace::did_change_file(const std::string file_uri, const document_change*, size_t) { parse_file(file_uri); }
-
-void workspace::did_change_watched_files(const std::string& file_uri)
+void workspace::did_change_file(const std::string file_uri, const document_change*, size_t)
 {
-    refresh_libraries();
+    macro_cache_.invalidate(file_uri);
     parse_file(file_uri);
 }
 
+void workspace::did_change_watched_files(const std::vector<std::string>& file_uris)
+{
+    refresh_libraries(file_uris);
+    for (const auto& file_uri : file_uris)
+        macro_cache_.invalidate(file_uri);
+
+    // change of the configuration parses all the dependants anyway
+    for (const auto& file_uri : file_uris)
+    {
+        std::filesystem::path file_path(file_uri);
+        if (file_path == proc_grps_path_ || file_path == pgm_conf_path_)
+        {
+            parse_file(file_uri);
+            return;
+        }
+    }
+
+    std::vector<processor_file_ptr> files_to_parse;
+    std::set<std::string> names;
+    for (const auto& file_uri : file_uris)
+    {
+        for (auto& f : find_files_to_parse_(file_uri))
+            if (names.insert(f->get_file_name()).second)
+                files_to_parse.push_back(std::move(f));
+    }
+    parse_files_(files_to_parse);
+}
+
 void workspace::open() { load_and_process_config(); }
 
 void workspace::close() { opened_ = false; }
@@ -261,6 +378,12 @@ bool workspace::load_and_process_config()
     std::filesystem::path ws_path(uri_);
 
     config_diags_.clear();
+    // processor groups are going to be recreated
+    start_id_generation_(true);
+    {
+        std::lock_guard guard(proc_grp_cache_.mutex);
+        proc_grp_cache_.groups.clear();
+    }
 
     opened_ = true;
 
@@ -270,7 +393,10 @@ bool workspace::load_and_process_config()
 
     bool load_ok = load_config(proc_grps_json, pgm_conf_json, pgm_conf_file);
     if (!load_ok)
+    {
+        apply_config_();
         return false;
+    }
 
     // get extensions from pgm conf
     extension_regex_map extensions;
@@ -292,6 +418,7 @@ bool workspace::load_and_process_config()
             new_config.diag_supress_limit = suppress_diags_limit_json->get<int64_t>();
     }*/
     local_config_ = lib_config::load_from_json(pgm_conf_json);
+    apply_config_();
 
     auto extensions_ptr = std::make_shared<const extension_regex_map>(std::move(extensions));
     // process processor groups
@@ -410,16 +537,14 @@ void workspace::filter_and_close_dependencies_(const std::set<std::string>& depe
     }
 
     // filters the files that are dependencies of other dependants and externally open files
-    for (auto dependant : dependants_)
+    for (auto it = filtered.begin(); it != filtered.end();)
     {
-        auto fdependant = file_manager_.find_processor_file(dependant);
-        if (!fdependant)
-            continue;
-        for (auto& dependency : fdependant->dependencies())
-        {
-            if (fdependant->get_file_name() != file->get_file_name() && filtered.find(dependency) != filtered.end())
-                filtered.erase(dependency);
-        }
+        auto dependants = dependants_index_.find(*it);
+        if (dependants != dependants_index_.end()
+            && (dependants->second.size() > 1 || *dependants->second.begin() != file->get_file_name()))
+            it = filtered.erase(it);
+        else
+            ++it;
     }
 
     // close all exclusive dependencies of file
@@ -432,29 +557,55 @@ void workspace::filter_and_close_dependencies_(const std::set<std::string>& depe
 
 bool workspace::is_dependency_(const std::string& file_uri)
 {
-    for (auto dependant : dependants_)
-    {
-        auto fdependant = file_manager_.find_processor_file(dependant);
-        if (!fdependant)
-            continue;
-        for (auto& dependency : fdependant->dependencies())
-        {
-            if (dependency == file_uri)
+    return dependants_index_.find(file_uri) != dependants_index_.end();
+}
+
+bool workspace::is_library_member_(const std::string& file_uri)
+{
+    for (auto& [name, proc_grp] : proc_grps_)
+        for (auto& lib : proc_grp.libraries())
+            if (lib->has_file(file_uri))
                 return true;
-        }
-    }
     return false;
 }
 
+void workspace::update_dependants_index_(processor_file_ptr file)
+{
+    // files that used to be dependencies are exactly the files to close
+    for (const auto& dependency : file->files_to_close())
+        remove_from_dependants_index_(dependency, file->get_file_name());
+    for (const auto& dependency : file->dependencies())
+        dependants_index_[dependency].insert(file->get_file_name());
+}
+
+void workspace::remove_from_dependants_index_(const std::string& dependency, const std::string& dependant)
+{
+    auto dependants = dependants_index_.find(dependency);
+    if (dependants == dependants_index_.end())
+        return;
+    dependants->second.erase(dependant);
+    if (dependants->second.empty())
+        dependants_index_.erase(dependants);
+}
+
 parse_result workspace::parse_library(
     const std::string& library, context::hlasm_context& hlasm_ctx, const library_data data)
 {
-    auto& proc_grp = get_proc_grp_by_program(hlasm_ctx.opencode_file_name());
+    auto& proc_grp = get_proc_grp_by_program_(hlasm_ctx);
     for (auto&& lib : proc_grp.libraries())
     {
-        std::shared_ptr<processor> found = lib->find_file(library);
+        processor_file_ptr found = lib->find_file(library);
         if (found)
-            return found->parse_macro(*this, hlasm_ctx, data);
+            return macro_cache_.parse_library(
+                macro_cache_key { found->get_file_name(),
+                    proc_grp.name(),
+                    data.proc_kind,
+                    hlasm_ctx.mnemonics_signature(),
+                    defer_macro_ca_operands_ },
+                *found,
+                *this,
+                hlasm_ctx,
+                library_data { data.proc_kind, data.library_member, defer_macro_ca_operands_ });
     }
 
     return false;
@@ -462,7 +613,7 @@ parse_result workspace::parse_library(
 
 bool workspace::has_library(const std::string& library, context::hlasm_context& hlasm_ctx) const
 {
-    auto& proc_grp = get_proc_grp_by_program(hlasm_ctx.opencode_file_name());
+    auto& proc_grp = get_proc_grp_by_program_(hlasm_ctx);
     for (auto&& lib : proc_grp.libraries())
     {
         std::shared_ptr<processor> found = lib->find_file(library);
@@ -473,4 +624,16 @@ bool workspace::has_library(const std::string& library, context::hlasm_context&
     return false;
 }
 
+std::shared_ptr<context::id_storage> workspace::get_id_storage() const { return ids_; }
+
+void workspace::start_id_generation_(bool force)
+{
+    if (!force && ids_->size() < id_storage_limit)
+        return;
+
+    // cached members refer to the identifiers of the previous storage
+    macro_cache_.clear();
+    ids_ = std::make_shared<context::id_storage>();
+}
+
 } // namespace hlasm_plugin::parser_library::workspaces
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "file_manager.h"
 #include "lib_config.h"
 #include "library.h"
+#include "macro_cache.h"
 #include "message_consumer.h"
 #include "processor.h"
 #include "processor_group.h"
@@ -53,6 +55,19 @@ struct program
     proc_grp_id pgroup;
 };
 
+// processor groups already assigned to programs, shared by analyses running in parallel
+struct proc_grp_cache
+{
+    std::unordered_map<std::string, const processor_group*> groups;
+    std::mutex mutex;
+
+    proc_grp_cache() = default;
+    // the cache is moved together with its workspace, which happens only before any analysis is started
+    proc_grp_cache(proc_grp_cache&& other) noexcept
+        : groups(std::move(other.groups))
+    {}
+};
+
 
 // Represents a LSP workspace. It solves all dependencies between files -
 // implements parse lib provider and decides which files are to be parsed
@@ -86,15 +101,18 @@ public:
     const processor_group& get_proc_grp_by_program(const std::string& program) const;
 
     void parse_file(const std::string& file_uri);
-    void refresh_libraries();
+    // updates the libraries that contain the files, other libraries are left untouched
+    void refresh_libraries(const std::vector<std::string>& file_uris);
     void did_open_file(const std::string& file_uri);
     void did_close_file(const std::string& file_uri);
     void did_change_file(const std::string document_uri, const document_change* changes, size_t ch_size);
-    void did_change_watched_files(const std::string& file_uri);
+    // handles a burst of changes at once, each affected program is parsed only once
+    void did_change_watched_files(const std::vector<std::string>& file_uris);
 
     virtual parse_result parse_library(
         const std::string& library, context::hlasm_context& hlasm_ctx, const library_data data) override;
     virtual bool has_library(const std::string& library, context::hlasm_context& hlasm_ctx) const override;
+    virtual std::shared_ptr<context::id_storage> get_id_storage() const override;
 
     const ws_uri& uri();
 
@@ -103,6 +121,9 @@ public:
 
     void set_message_consumer(message_consumer* consumer);
 
+    // applies the settings after a change of the global configuration
+    void configuration_changed();
+
 protected:
     file_manager& get_file_manager();
 
@@ -110,6 +131,7 @@ private:
     constexpr static char FILENAME_PROC_GRPS[] = "proc_grps.json";
     constexpr static char FILENAME_PGM_CONF[] = "pgm_conf.json";
     constexpr static char HLASM_PLUGIN_FOLDER[] = ".hlasmplugin";
+    constexpr static char MACRO_CACHE_FOLDER[] = "macro_cache";
 
     std::atomic<bool>* cancel_;
 
@@ -121,6 +143,7 @@ private:
     std::map<std::string, program> exact_pgm_conf_;
     std::vector<std::pair<program, std::regex>> regex_pgm_conf_;
     processor_group implicit_proc_grp;
+    mutable proc_grp_cache proc_grp_cache_;
 
     std::filesystem::path ws_path_;
     std::filesystem::path proc_grps_path_;
@@ -128,6 +151,13 @@ private:
 
     bool opened_ = false;
 
+    // identifiers shared by all analyses in the workspace, so that they can reuse cached library members
+    // the storage is replaced together with the macro cache when the configuration changes or it grows too large
+    std::shared_ptr<context::id_storage> ids_;
+    macro_cache macro_cache_;
+    // replaces the identifier storage when forced or over the limit, analyses still running keep the old one
+    void start_id_generation_(bool force);
+
 
     bool load_and_process_config();
     // Loads the pgm_conf.json and proc_grps.json from disk, adds them to file_manager_ and parses both jsons.
@@ -138,14 +168,34 @@ private:
 
     // files, that depend on others (e.g. open code files that use macros)
     std::set<std::string> dependants_;
+    // reverse index of dependencies of the dependants, maps a dependency to all files that depend on it
+    std::unordered_map<std::string, std::set<std::string>> dependants_index_;
 
     diagnostic_container config_diags_;
 
+    // Parses the files on the number of threads given by the configuration. Diagnostics of all the files
+    // are available once the function returns.
+    void parse_dependants_in_parallel(const std::vector<processor_file_ptr>& files);
+    // returns the files that need to be parsed after the file has been changed
+    std::vector<processor_file_ptr> find_files_to_parse_(const std::string& file_uri);
+    void parse_files_(const std::vector<processor_file_ptr>& files_to_parse);
+
     void filter_and_close_dependencies_(const std::set<std::string>& dependencies, processor_file_ptr file);
     bool is_dependency_(const std::string& file_uri);
+    // whether the file is in a library of any processor group of the current configuration
+    bool is_library_member_(const std::string& file_uri);
+    // updates the reverse index after the file was parsed
+    void update_dependants_index_(processor_file_ptr file);
+    void remove_from_dependants_index_(const std::string& dependency, const std::string& dependant);
 
     bool program_id_match(const std::string& filename, const program_id& program) const;
 
+    // resolves the processor group of the program from the configuration
+    const processor_group& find_proc_grp_by_program_(const std::string& filename) const;
+    // returns the cached processor group of the program, the bool is true if the group was already in the cache
+    std::pair<const processor_group&, bool> get_cached_proc_grp_(const std::string& filename) const;
+    const processor_group& get_proc_grp_by_program_(context::hlasm_context& hlasm_ctx) const;
+
     void delete_diags(processor_file_ptr file);
 
     void show_message(const std::string& message);
@@ -157,6 +207,10 @@ private:
     const lib_config& global_config_;
     lib_config local_config_;
     lib_config get_config();
+    // the settings used by the analyses are applied when the configuration is loaded or changed,
+    // so that the library lookups do not merge the configurations
+    void apply_config_();
+    bool defer_macro_ca_operands_ = false;
 };
 
 } // namespace hlasm_plugin::parser_library::workspaces
@@ -63,6 +63,28 @@ TEST(context_id_storage, case_insensitive)
     ASSERT_TRUE(it1 == it3);
 }
 
+TEST(context_id_storage, find_long)
+{
+    id_storage ids;
+
+    std::string name(100, 'a');
+    auto it1 = ids.add(name);
+    auto it2 = ids.find(std::string(100, 'A'));
+    ASSERT_TRUE(it1 == it2);
+    EXPECT_EQ(*it1, std::string(100, 'A'));
+    EXPECT_EQ(ids.find(std::string(101, 'a')), nullptr);
+}
+
+TEST(context_id_storage, uri)
+{
+    id_storage ids;
+
+    auto it1 = ids.add("file/name", true);
+    EXPECT_EQ(*it1, "file/name");
+    EXPECT_NE(it1, ids.add("file/name"));
+    EXPECT_EQ(ids.add("COPY"), ids.well_known.COPY);
+}
+
 TEST(context, create_global_var)
 {
     hlasm_context ctx;
@@ -75,7 +97,7 @@ TEST(context, create_global_var)
     auto found = ctx.get_var_sym(idx);
 
 
-    ASSERT_TRUE(glob == found);
+    ASSERT_TRUE(glob.get() == found);
     ASSERT_TRUE(glob == ctx.globals().find(idx)->second);
 }
 
@@ -91,7 +113,7 @@ TEST(context, create_local_var)
     auto found = ctx.get_var_sym(idx);
 
 
-    ASSERT_TRUE(loc == found);
+    ASSERT_TRUE(loc.get() == found);
     ASSERT_TRUE(ctx.globals().find(idx) == ctx.globals().end());
 }
 
@@ -175,6 +197,61 @@ TEST(context_set_vars, set_non_scalar)
     EXPECT_EQ(var.get_value(1000), "");
 }
 
+TEST(context_set_vars, non_scalar_attributes)
+{
+    hlasm_context ctx;
+
+
+    auto idx = ctx.ids().add("var");
+
+    set_symbol<string> var(idx, false, false);
+
+    EXPECT_EQ(var.number({}), 0);
+    EXPECT_EQ(var.size(), (size_t)0);
+
+    var.set_value("abc", 0);
+    var.set_value("d", 2);
+    var.set_value("ef", 5);
+
+    EXPECT_EQ(var.number({}), 6);
+    EXPECT_EQ(var.size(), (size_t)3);
+    EXPECT_EQ(var.keys(), (std::vector<size_t> { 0, 2, 5 }));
+    EXPECT_EQ(var.count({ 1 }), 3);
+    EXPECT_EQ(var.count({ 2 }), 0);
+    EXPECT_EQ(var.count({ 6 }), 2);
+
+    // filling the gap joins the following values
+    var.set_value("gh", 1);
+
+    EXPECT_EQ(var.number({}), 6);
+    EXPECT_EQ(var.size(), (size_t)4);
+    EXPECT_EQ(var.keys(), (std::vector<size_t> { 0, 1, 2, 5 }));
+    EXPECT_EQ(var.get_value(2), "d");
+    EXPECT_EQ(var.get_value(5), "ef");
+    EXPECT_EQ(var.count({ 2 }), 2);
+
+    set_symbol<int> scalar(idx, true, false);
+
+    EXPECT_EQ(scalar.number({}), 0);
+    EXPECT_EQ(scalar.size(), (size_t)0);
+
+    scalar.set_value(123);
+
+    EXPECT_EQ(scalar.number({}), 0);
+    EXPECT_EQ(scalar.size(), (size_t)1);
+    EXPECT_EQ(scalar.count({}), 3);
+
+    set_symbol<bool> logical(idx, false, false);
+
+    logical.set_value(true, 1);
+    logical.set_value(true, 0);
+
+    EXPECT_EQ(logical.number({}), 2);
+    EXPECT_EQ(logical.get_value(0), true);
+    EXPECT_EQ(logical.get_value(1), true);
+    EXPECT_EQ(logical.get_value(2), false);
+}
+
 
 TEST(context_macro_param, param_data)
 {
@@ -312,7 +389,7 @@ TEST(context_macro, call_and_leave_macro)
     ASSERT_TRUE(ctx.is_in_macro());
     ASSERT_TRUE(ctx.this_macro() == m2);
 
-    auto SYSLIST = m2->named_params.find(ctx.ids().add("SYSLIST"))->second->access_system_variable();
+    auto SYSLIST = m2->find_param(ctx.ids().add("SYSLIST"))->access_system_variable();
     ASSERT_TRUE(SYSLIST);
     // testing syslist
     EXPECT_EQ(SYSLIST->get_value((size_t)0), "");
@@ -321,9 +398,9 @@ TEST(context_macro, call_and_leave_macro)
     EXPECT_EQ(SYSLIST->get_value((size_t)3), "");
 
     // testing named params
-    EXPECT_EQ(m2->named_params.find(op1)->second->get_value(), "ada");
-    EXPECT_EQ(m2->named_params.find(op3)->second->get_value(), "");
-    EXPECT_EQ(m2->named_params.find(key)->second->get_value(), "");
+    EXPECT_EQ(m2->find_param(op1)->get_value(), "ada");
+    EXPECT_EQ(m2->find_param(op3)->get_value(), "");
+    EXPECT_EQ(m2->find_param(key)->get_value(), "");
 
     ctx.leave_macro();
 
@@ -372,7 +449,7 @@ TEST(context_macro, repeat_call_same_macro)
     // call->|lbl		MAC		ada,mko,
     auto m2 = ctx.enter_macro(idx, move(lb), move(params));
 
-    EXPECT_EQ(m2->named_params.find(lbl)->second->get_value(), "lbl");
+    EXPECT_EQ(m2->find_param(lbl)->get_value(), "lbl");
 
     // leaving macro
     ctx.leave_macro();
@@ -404,7 +481,7 @@ TEST(context_macro, repeat_call_same_macro)
 
     ASSERT_TRUE(m2 != m3);
 
-    auto SYSLIST = m3->named_params.find(ctx.ids().add("SYSLIST"))->second->access_system_variable();
+    auto SYSLIST = m3->find_param(ctx.ids().add("SYSLIST"))->access_system_variable();
     ASSERT_TRUE(SYSLIST);
 
     for (size_t i = 0; i < 3; i++)
@@ -412,10 +489,10 @@ TEST(context_macro, repeat_call_same_macro)
         EXPECT_EQ(SYSLIST->get_value(i), "");
     }
 
-    EXPECT_EQ(m3->named_params.find(lbl)->second->get_value(), "");
-    EXPECT_EQ(m3->named_params.find(op1)->second->get_value(), "");
-    EXPECT_EQ(m3->named_params.find(op3)->second->get_value(), "(first,second,third)");
-    EXPECT_EQ(m3->named_params.find(key)->second->get_value(), "cas");
+    EXPECT_EQ(m3->find_param(lbl)->get_value(), "");
+    EXPECT_EQ(m3->find_param(op1)->get_value(), "");
+    EXPECT_EQ(m3->find_param(op3)->get_value(), "(first,second,third)");
+    EXPECT_EQ(m3->find_param(key)->get_value(), "cas");
 
     EXPECT_EQ(SYSLIST->get_value({ 2, 3 }), "");
     EXPECT_EQ(SYSLIST->get_value(3), "(first,second,third)");
@@ -503,9 +580,9 @@ TEST(context_macro, recurr_call)
     ASSERT_TRUE(ctx.is_in_macro());
     ASSERT_FALSE(m2 == m3);
 
-    auto SYSLIST2 = m2->named_params.find(ctx.ids().add("SYSLIST"))->second->access_system_variable();
+    auto SYSLIST2 = m2->find_param(ctx.ids().add("SYSLIST"))->access_system_variable();
     ASSERT_TRUE(SYSLIST2);
-    auto SYSLIST3 = m3->named_params.find(ctx.ids().add("SYSLIST"))->second->access_system_variable();
+    auto SYSLIST3 = m3->find_param(ctx.ids().add("SYSLIST"))->access_system_variable();
     ASSERT_TRUE(SYSLIST3);
 
     for (size_t i = 0; i < 2; i++)
@@ -514,10 +591,10 @@ TEST(context_macro, recurr_call)
     }
 
     // testing inner macro
-    EXPECT_EQ(m3->named_params.find(lbl)->second->get_value(), "");
-    EXPECT_EQ(m3->named_params.find(op1)->second->get_value(), "");
-    EXPECT_EQ(m3->named_params.find(op3)->second->get_value(), "(first,second,third)");
-    EXPECT_EQ(m3->named_params.find(key)->second->get_value(), "cas");
+    EXPECT_EQ(m3->find_param(lbl)->get_value(), "");
+    EXPECT_EQ(m3->find_param(op1)->get_value(), "");
+    EXPECT_EQ(m3->find_param(op3)->get_value(), "(first,second,third)");
+    EXPECT_EQ(m3->find_param(key)->get_value(), "cas");
 
     EXPECT_EQ(SYSLIST3->get_value(0), "");
     EXPECT_EQ(SYSLIST3->get_value({ 2, 3 }), "");
@@ -532,9 +609,9 @@ TEST(context_macro, recurr_call)
     EXPECT_EQ(SYSLIST2->get_value((size_t)2), "mko");
     EXPECT_EQ(SYSLIST2->get_value((size_t)3), "");
 
-    EXPECT_EQ(m2->named_params.find(op1)->second->get_value(), "ada");
-    EXPECT_EQ(m2->named_params.find(op3)->second->get_value(), "");
-    EXPECT_EQ(m2->named_params.find(key)->second->get_value(), "");
+    EXPECT_EQ(m2->find_param(op1)->get_value(), "ada");
+    EXPECT_EQ(m2->find_param(op3)->get_value(), "");
+    EXPECT_EQ(m2->find_param(key)->get_value(), "");
 
 
     ctx.leave_macro();
@@ -364,8 +364,8 @@ TEST(macro, macro_name_param_repetition)
             m1->call(std::make_unique<macro_param_data_single>("1"), std::move(args), a.context().ids().add("SYSLIST"));
         auto n = a.context().ids().add("n");
         auto b = a.context().ids().add("b");
-        EXPECT_EQ(invo->named_params.find(n)->second->get_value(), "1");
-        EXPECT_EQ(invo->named_params.find(b)->second->get_value(), "3");
+        EXPECT_EQ(invo->find_param(n)->get_value(), "1");
+        EXPECT_EQ(invo->find_param(b)->get_value(), "3");
     }
 
     {
@@ -375,9 +375,9 @@ TEST(macro, macro_name_param_repetition)
         auto invo = m2->call(nullptr, std::move(args), a.context().ids().add("SYSLIST"));
         auto n = a.context().ids().add("a");
         auto b = a.context().ids().add("b");
-        EXPECT_EQ(invo->named_params.find(n)->second->get_value(), "1");
-        EXPECT_EQ(invo->named_params.find(b)->second->get_value(), "2");
-        EXPECT_EQ(invo->named_params.find(a.context().ids().add("SYSLIST"))->second->get_value(1), "1");
+        EXPECT_EQ(invo->find_param(n)->get_value(), "1");
+        EXPECT_EQ(invo->find_param(b)->get_value(), "2");
+        EXPECT_EQ(invo->find_param(a.context().ids().add("SYSLIST"))->get_value(1), "1");
     }
 
     {
@@ -388,8 +388,8 @@ TEST(macro, macro_name_param_repetition)
         auto invo = m3->call(nullptr, std::move(args), a.context().ids().add("SYSLIST"));
         auto n = a.context().ids().add("a");
         auto b = a.context().ids().add("b");
-        EXPECT_EQ(invo->named_params.find(n)->second->access_keyword_param()->get_value(), "5");
-        EXPECT_EQ(invo->named_params.find(b)->second->get_value(), "2");
+        EXPECT_EQ(invo->find_param(n)->access_keyword_param()->get_value(), "5");
+        EXPECT_EQ(invo->find_param(b)->get_value(), "2");
     }
 }
 
@@ -593,6 +593,96 @@ TEST(external_macro, library_with_begin_comment)
     EXPECT_EQ(a.parser().getNumberOfSyntaxErrors(), (size_t)0);
 }
 
+class lazy_mock : public parse_lib_provider
+{
+public:
+    explicit lazy_mock(bool defer_ca_operands)
+        : defer_ca_operands(defer_ca_operands)
+    {}
+
+    virtual parse_result parse_library(const std::string&, context::hlasm_context& hlasm_ctx, const library_data data)
+    {
+        a = std::make_unique<analyzer>(content,
+            "/tmp/MAC",
+            hlasm_ctx,
+            *this,
+            library_data { data.proc_kind, data.library_member, defer_ca_operands });
+        a->analyze();
+        a->collect_diags();
+        return true;
+    }
+    virtual bool has_library(const std::string&, context::hlasm_context&) const { return true; }
+    std::unique_ptr<analyzer> a;
+
+private:
+    bool defer_ca_operands;
+    const std::string content =
+        R"(   MACRO
+       MAC   &P
+       GBLA  &X
+       AIF   ('&P' EQ 'SKIP').END
+&X     SETA  (1+
+.END   ANOP
+&X     SETA  &X+5
+       MEND
+)";
+};
+
+TEST(external_macro, eager_ca_operands)
+{
+    std::string input =
+        R"(
+ GBLA &X
+ MAC SKIP
+)";
+    lazy_mock m(false);
+    analyzer a(input, "", m);
+    a.analyze();
+    a.collect_diags();
+
+    // by default, the syntax error is reported when the macro is defined, even though the statement is never executed
+    EXPECT_GT(dynamic_cast<diagnosable*>(&*m.a)->diags().size(), (size_t)0);
+
+    auto X = a.context().globals().find(a.context().ids().add("X"));
+    ASSERT_NE(X, a.context().globals().end());
+    EXPECT_EQ(X->second->access_set_symbol<A_t>()->get_value(), 5);
+
+    auto& definition = a.context().macros().at(a.context().ids().add("MAC"))->cached_definition;
+    ASSERT_EQ(definition.size(), (size_t)6);
+    EXPECT_EQ(definition[1].get_base()->kind, context::statement_kind::RESOLVED);
+    EXPECT_EQ(definition[2].get_base()->kind, context::statement_kind::RESOLVED);
+}
+
+TEST(external_macro, lazy_ca_operands)
+{
+    std::string input =
+        R"(
+ GBLA &X
+ MAC SKIP
+)";
+    lazy_mock m(true);
+    analyzer a(input, "", m);
+    a.analyze();
+    a.collect_diags();
+
+    // the statement with the syntax error is never executed, so the error is not reported in the deferred mode
+    EXPECT_EQ(dynamic_cast<diagnosable*>(&*m.a)->diags().size(), (size_t)0);
+    EXPECT_EQ(dynamic_cast<diagnosable*>(&a)->diags().size(), (size_t)0);
+
+    auto X = a.context().globals().find(a.context().ids().add("X"));
+    ASSERT_NE(X, a.context().globals().end());
+    EXPECT_EQ(X->second->access_set_symbol<A_t>()->get_value(), 5);
+
+    // operands of conditional assembly statements are parsed only when the statement is executed
+    auto& definition = a.context().macros().at(a.context().ids().add("MAC"))->cached_definition;
+    ASSERT_EQ(definition.size(), (size_t)6);
+    EXPECT_EQ(definition[1].get_base()->kind, context::statement_kind::DEFERRED);
+    EXPECT_TRUE(definition[1].contains(processing_form::CA));
+    EXPECT_EQ(definition[2].get_base()->kind, context::statement_kind::DEFERRED);
+    EXPECT_FALSE(definition[2].contains(processing_form::CA));
+    EXPECT_TRUE(definition[4].contains(processing_form::CA));
+}
+
 TEST(variable_argument_passing, positive_sublist)
 {
     auto data = macro_processor::string_to_macrodata("(a,b,c)");
@@ -704,3 +794,49 @@ TEST(macro, parse_args)
     EXPECT_EQ(a.diags().size(), (size_t)0);
     EXPECT_EQ(a.parser().getNumberOfSyntaxErrors(), (size_t)0);
 }
+
+TEST(macro, variable_frames)
+{
+    std::string input =
+        R"(
+ MACRO
+ M &N
+ GBLA &SUM
+ LCLA &L
+&L SETA &N
+ AIF (&N EQ 0).END
+&NEXT SETA &N-1
+ M &NEXT
+.END ANOP
+&SUM SETA &SUM+&L
+ MEND
+
+ MACRO
+ M2 &P
+ GBLC &RES
+&RES SETC '&P.&SYSLIST(1)'
+ MEND
+
+ GBLA &SUM
+ GBLC &RES
+ M 3
+ M2 VISIBLE
+)";
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("SUM"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<context::A_t>()
+                  ->get_value(),
+        6);
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("RES"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<context::C_t>()
+                  ->get_value(),
+        "VISIBLEVISIBLE");
+    EXPECT_EQ(a.diags().size(), (size_t)0);
+}
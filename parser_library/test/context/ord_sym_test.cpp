@@ -433,3 +433,66 @@ C EQU B-A
 
     EXPECT_EQ(a.diags().size(), (size_t)0);
 }
+
+TEST(ordinary_symbols, long_forward_reference_chain)
+{
+    std::string input;
+    for (size_t i = 0; i < 500; ++i)
+        input += "S" + std::to_string(i) + " EQU S" + std::to_string(i + 1) + "+1\n";
+    input += "S500 EQU 0\n";
+    input += " DS (S0)C\n";
+
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.diags().size(), (size_t)0);
+
+    auto s0 = a.context().ord_ctx.get_symbol(a.context().ids().add("S0"));
+    ASSERT_TRUE(s0);
+    ASSERT_EQ(s0->kind(), symbol_value_kind::ABS);
+    EXPECT_EQ(s0->value().get_abs(), 500);
+}
+
+TEST(ordinary_symbols, long_cyclic_dependency)
+{
+    std::string input;
+    for (size_t i = 0; i < 500; ++i)
+        input += "S" + std::to_string(i) + " EQU S" + std::to_string(i + 1) + "+1\n";
+    input += "S500 EQU S0\n";
+
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.diags().size(), (size_t)1);
+    EXPECT_TRUE(a.context().ord_ctx.symbol_defined(a.context().ids().add("S0")));
+    EXPECT_TRUE(a.context().ord_ctx.symbol_defined(a.context().ids().add("S500")));
+}
+
+TEST(ordinary_symbols, forward_reference_to_section_and_loctr)
+{
+    std::string input = R"(
+A EQU B+2
+E EQU A-B
+C EQU L
+B CSECT
+L LOCTR
+)";
+
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.diags().size(), (size_t)0);
+
+    auto get = [&a](const char* name) { return a.context().ord_ctx.get_symbol(a.context().ids().add(name)); };
+
+    ASSERT_TRUE(get("A"));
+    EXPECT_EQ(get("A")->kind(), symbol_value_kind::RELOC);
+    ASSERT_TRUE(get("C"));
+    EXPECT_EQ(get("C")->kind(), symbol_value_kind::RELOC);
+    ASSERT_TRUE(get("E"));
+    ASSERT_EQ(get("E")->kind(), symbol_value_kind::ABS);
+    EXPECT_EQ(get("E")->value().get_abs(), 2);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "gmock/gmock.h"
+
+#include "../common_testing.h"
+#include "expr_mocks.h"
+#include "expressions/conditional_assembly/ca_bytecode.h"
+#include "expressions/conditional_assembly/ca_operator_binary.h"
+#include "expressions/conditional_assembly/ca_operator_unary.h"
+#include "expressions/conditional_assembly/terms/ca_constant.h"
+#include "expressions/conditional_assembly/terms/ca_var_sym.h"
+#include "expressions/evaluation_context.h"
+
+using namespace hlasm_plugin::parser_library::expressions;
+using namespace hlasm_plugin::parser_library;
+
+namespace {
+ca_expr_ptr constant(context::A_t value) { return std::make_unique<ca_constant>(value, range()); }
+
+template<typename OP>
+ca_expr_ptr basic_op(ca_expr_ptr lhs, ca_expr_ptr rhs)
+{
+    return std::make_unique<ca_basic_binary_operator<OP>>(std::move(lhs), std::move(rhs), range());
+}
+
+ca_expr_ptr function_op(ca_expr_ptr lhs, ca_expr_ptr rhs, ca_expr_ops function, context::SET_t_enum kind)
+{
+    return std::make_unique<ca_function_binary_operator>(std::move(lhs), std::move(rhs), function, kind, range());
+}
+} // namespace
+
+TEST(ca_bytecode, arithmetic)
+{
+    context::hlasm_context ctx;
+    lib_prov_mock lib;
+    evaluation_context eval_ctx { ctx, lib };
+
+    // (1+2)*3-10/(5-5)
+    auto expr = basic_op<ca_sub>(basic_op<ca_mul>(std::make_unique<ca_par_operator>(
+                                                      basic_op<ca_add>(constant(1), constant(2)), range()),
+                                     constant(3)),
+        basic_op<ca_div>(constant(10), basic_op<ca_sub>(constant(5), constant(5))));
+
+    auto bytecode = ca_bytecode::compile(*expr);
+    ASSERT_TRUE(bytecode);
+
+    EXPECT_EQ(bytecode->evaluate<context::A_t>(eval_ctx), 9);
+    EXPECT_EQ(expr->evaluate<context::A_t>(eval_ctx), 9);
+    EXPECT_EQ(eval_ctx.diags().size(), 0U);
+}
+
+TEST(ca_bytecode, logical)
+{
+    context::hlasm_context ctx;
+    lib_prov_mock lib;
+    evaluation_context eval_ctx { ctx, lib };
+
+    // (1 LT 2) AND NOT (3 EQ 4)
+    auto expr = function_op(function_op(constant(1), constant(2), ca_expr_ops::LT, context::SET_t_enum::B_TYPE),
+        std::make_unique<ca_function_unary_operator>(
+            function_op(constant(3), constant(4), ca_expr_ops::EQ, context::SET_t_enum::B_TYPE),
+            ca_expr_ops::NOT,
+            context::SET_t_enum::B_TYPE,
+            range()),
+        ca_expr_ops::AND,
+        context::SET_t_enum::B_TYPE);
+
+    auto bytecode = ca_bytecode::compile(*expr);
+    ASSERT_TRUE(bytecode);
+
+    EXPECT_EQ(bytecode->evaluate<context::B_t>(eval_ctx), true);
+    EXPECT_EQ(expr->evaluate<context::B_t>(eval_ctx), true);
+    EXPECT_EQ(eval_ctx.diags().size(), 0U);
+}
+
+TEST(ca_bytecode, overflow)
+{
+    context::hlasm_context ctx;
+    lib_prov_mock lib;
+    evaluation_context eval_ctx { ctx, lib };
+
+    auto expr = basic_op<ca_add>(constant(2147483647), constant(1));
+
+    auto bytecode = ca_bytecode::compile(*expr);
+    ASSERT_TRUE(bytecode);
+
+    EXPECT_EQ(bytecode->evaluate<context::A_t>(eval_ctx), 0);
+    EXPECT_EQ(eval_ctx.diags().size(), 1U);
+}
+
+TEST(ca_bytecode, variable_symbol_term)
+{
+    context::hlasm_context ctx;
+    lib_prov_mock lib;
+    evaluation_context eval_ctx { ctx, lib };
+
+    auto name = ctx.ids().add("V");
+    ctx.create_local_variable<context::A_t>(name, true)->access_set_symbol<context::A_t>()->set_value(5);
+
+    // &V*2+1
+    auto var = std::make_unique<ca_var_sym>(
+        std::make_unique<semantics::basic_variable_symbol>(name, std::vector<ca_expr_ptr> {}, range()), range());
+    auto expr = basic_op<ca_add>(basic_op<ca_mul>(std::move(var), constant(2)), constant(1));
+
+    auto bytecode = ca_bytecode::compile(*expr);
+    ASSERT_TRUE(bytecode);
+
+    EXPECT_EQ(bytecode->evaluate<context::A_t>(eval_ctx), 11);
+    EXPECT_EQ(eval_ctx.diags().size(), 0U);
+}
+
+TEST(ca_bytecode, single_term_not_compiled)
+{
+    auto expr = std::make_unique<ca_par_operator>(constant(1), range());
+
+    EXPECT_FALSE(ca_bytecode::compile(*expr));
+}
+
+TEST(ca_bytecode, macro_loop)
+{
+    std::string input = R"(
+ MACRO
+ M
+ GBLA &SUM
+ LCLA &I
+.LOOP AIF (&I GE 10 OR &SUM GT 1000).END
+&I SETA &I+1
+&SUM SETA &SUM+(&I*2-1)
+ AGO .LOOP
+.END MEND
+
+ GBLA &SUM
+ M
+)";
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.diags().size(), 0U);
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("SUM"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<context::A_t>()
+                  ->get_value(),
+        100);
+}
@@ -19,6 +19,7 @@
 #include "antlr4-runtime.h"
 #include "gtest/gtest.h"
 
+#include "analyzer.h"
 #include "hlasmparser.h"
 #include "lexing/input_source.h"
 #include "lexing/lexer.h"
@@ -342,3 +343,63 @@ TEST(lexer_test, attribute_in_continuation)
     ASSERT_EQ(l.nextToken()->getType(), hlasm_plugin::parser_library::lexing::lexer::ATTR);
     ASSERT_EQ(l.nextToken()->getType(), hlasm_plugin::parser_library::lexing::lexer::ORDSYMBOL);
 }
+
+TEST(lexer_test, windowed_token_stream)
+{
+    std::string in = R"(A EQU 1
+B EQU 2
+C EQU 3
+)";
+
+    hlasm_plugin::parser_library::semantics::lsp_info_processor lsp_proc = { "", "", nullptr, false };
+    hlasm_plugin::parser_library::lexing::input_source input(in);
+    hlasm_plugin::parser_library::lexing::lexer l(&input, &lsp_proc);
+    hlasm_plugin::parser_library::lexing::token_stream tokens(&l);
+    tokens.enable_windowing();
+
+    auto consume_statement = [&tokens]() {
+        while (tokens.LA(1) != hlasm_plugin::parser_library::lexing::lexer::EOLLN)
+            tokens.consume();
+        tokens.consume();
+    };
+
+    consume_statement();
+    tokens.release_processed();
+    size_t second_start = tokens.index();
+
+    consume_statement();
+    tokens.release_processed();
+
+    // the tokens of the first statement are freed, the second one is kept for the lookback
+    EXPECT_EQ(tokens.get(0), nullptr);
+    ASSERT_NE(tokens.get(second_start), nullptr);
+    EXPECT_EQ(tokens.get(second_start)->getTokenIndex(), second_start);
+    EXPECT_EQ(tokens.LT(-1)->getType(), hlasm_plugin::parser_library::lexing::lexer::EOLLN);
+    EXPECT_EQ(tokens.LT(1)->getText(), "C");
+}
+
+TEST(lexer_test, windowed_token_stream_jumps)
+{
+    std::string in = R"(
+&I   SETA 0
+.LOOP ANOP
+&I   SETA &I+1
+     AIF (&I LT 100).LOOP
+     AIF (L'X EQ 4).END
+&I   SETA 0
+.END ANOP
+X    DS   F
+)";
+
+    hlasm_plugin::parser_library::analyzer a(in);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.diags().size(), (size_t)0);
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("I"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<hlasm_plugin::parser_library::context::A_t>()
+                  ->get_value(),
+        100);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "gtest/gtest.h"
+
+#include "lexing/line_table.h"
+
+using namespace hlasm_plugin::parser_library::lexing;
+
+TEST(line_table, find_line_break)
+{
+    std::string text = "first line is long\r\nsecond\n\rthird";
+
+    EXPECT_EQ(find_line_break(text, 0), 18U);
+    EXPECT_EQ(find_line_break(text, 19), 19U);
+    EXPECT_EQ(find_line_break(text, 20), 26U);
+    EXPECT_EQ(find_line_break(text, 27), 27U);
+    EXPECT_EQ(find_line_break(text, 28), std::string_view::npos);
+}
+
+TEST(line_table, is_ascii)
+{
+    EXPECT_TRUE(is_ascii(""));
+    EXPECT_TRUE(is_ascii("LABEL    LR    1,2"));
+    EXPECT_FALSE(is_ascii("LABEL    LR    1,2  \xC3\xA4"));
+    EXPECT_FALSE(is_ascii("\xC3\xA4 LABEL    LR    1,2"));
+}
+
+TEST(line_table, lines)
+{
+    std::string text = "A LR 1,2\r\n* comment \xC3\xA4\n\nB";
+    line_table lines(text);
+
+    ASSERT_EQ(lines.size(), 4U);
+
+    // '\r' is a part of the line, the lexer ignores it
+    EXPECT_EQ(lines[0].begin, 0U);
+    EXPECT_EQ(lines[0].end, 9U);
+    EXPECT_TRUE(lines[0].ascii);
+
+    EXPECT_EQ(lines[1].begin, 10U);
+    EXPECT_EQ(lines[1].end, 22U);
+    EXPECT_FALSE(lines[1].ascii);
+
+    EXPECT_EQ(lines[2].begin, 23U);
+    EXPECT_EQ(lines[2].end, 23U);
+
+    EXPECT_EQ(lines[3].begin, 24U);
+    EXPECT_EQ(lines[3].end, 25U);
+
+    EXPECT_EQ(lines.find(0), 0U);
+    EXPECT_EQ(lines.find(9), 0U);
+    EXPECT_EQ(lines.find(10, 3), 1U);
+    EXPECT_EQ(lines.find(23, 1), 2U);
+    EXPECT_EQ(lines.find(25), 3U);
+    EXPECT_EQ(lines.find(26), lines.size());
+}
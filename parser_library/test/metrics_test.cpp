@@ -13,6 +13,7 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -149,9 +150,68 @@ TEST_F(benchmark_test, reparsed_statements)
     EXPECT_EQ(a->get_metrics().reparsed_statements, (size_t)4);
 }
 
+TEST_F(benchmark_test, reparse_cache_hits)
+{
+    setUpAnalyzer(R"(
+&I  SETA 0
+.L  ANOP
+&I  SETA &I+1
+&V  SETC '1'
+    LR  &V,&V
+    AIF (&I LT 10).L)");
+    // the same substituted operand field is parsed only in the first iteration
+    EXPECT_EQ(a->get_metrics().reparsed_statements, (size_t)10);
+    EXPECT_EQ(a->get_metrics().reparse_cache_hits, (size_t)9);
+}
+
+TEST_F(benchmark_test, reparse_cache_diagnostics)
+{
+    setUpAnalyzer(R"(
+&I  SETA 0
+.L  ANOP
+&I  SETA &I+1
+&V  SETC '1,('
+    LR  &V
+    AIF (&I LT 3).L)");
+    a->collect_diags();
+    EXPECT_EQ(a->get_metrics().reparse_cache_hits, (size_t)2);
+
+    // the syntax error is reported by every iteration, including those served from the cache
+    std::vector<const diagnostic_s*> syntax_errors;
+    for (const auto& d : a->diags())
+        if (d.message.find("While substituting") == 0)
+            syntax_errors.push_back(&d);
+    ASSERT_EQ(syntax_errors.size(), (size_t)3);
+    EXPECT_EQ(syntax_errors[0]->message, syntax_errors[2]->message);
+    EXPECT_EQ(syntax_errors[0]->diag_range, syntax_errors[2]->diag_range);
+}
+
+TEST_F(benchmark_test, ll_fallbacks)
+{
+    setUpAnalyzer(" LR 1,1\n LR 1,2");
+    EXPECT_GE(a->get_metrics().sll_parses, (size_t)2);
+    EXPECT_EQ(a->get_metrics().ll_fallbacks, (size_t)0);
+
+    setUpAnalyzer(" LR 1,1\n LR 1,(");
+    // only the statement with the syntax error is parsed again
+    EXPECT_GE(a->get_metrics().sll_parses, (size_t)2);
+    EXPECT_EQ(a->get_metrics().ll_fallbacks, (size_t)1);
+    a->collect_diags();
+    EXPECT_FALSE(a->diags().empty());
+}
+
 TEST_F(benchmark_test, lookahead_statements)
 {
     setUpAnalyzer(" AGO .HERE\n something\n something\n.HERE ANOP");
     // 2 lines skipped by lookahead + 1 which finds the symbol
     EXPECT_EQ(a->get_metrics().lookahead_statements, (size_t)3);
 }
+
+TEST_F(benchmark_test, lexed_tokens)
+{
+    setUpAnalyzer(" LR 1,1");
+    // space, instruction, space, 3 operand tokens, end of line and end of file
+    EXPECT_GE(a->get_metrics().lexed_tokens, (size_t)7);
+    // tokens are allocated in blocks
+    EXPECT_EQ(a->get_metrics().token_allocations, (size_t)1);
+}
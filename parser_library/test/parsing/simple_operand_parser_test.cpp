@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+
+#include "gtest/gtest.h"
+
+#include "../common_testing.h"
+#include "../expressions/expr_mocks.h"
+#include "parsing/simple_operand_parser.h"
+
+// tests for the hand-written parser of simple machine operands:
+// the results must be the same as the results of the ANTLR parser
+
+namespace {
+
+std::string print_range(const range& r)
+{
+    return std::to_string(r.start.line) + ":" + std::to_string(r.start.column) + "-" + std::to_string(r.end.line)
+        + ":" + std::to_string(r.end.column);
+}
+
+std::string print_value(const symbol_value& value)
+{
+    if (value.value_kind() == symbol_value_kind::ABS)
+        return std::to_string(value.get_abs());
+    return "kind " + std::to_string((int)value.value_kind());
+}
+
+std::string print_expr(const mach_expr_ptr& expr)
+{
+    if (!expr)
+        return "null";
+    dep_sol_mock solver;
+    return std::string(typeid(*expr).name()) + "(" + print_range(expr->get_range()) + ")="
+        + print_value(expr->evaluate(solver));
+}
+
+// textual form of the operands that contains their kinds, ranges and expressions
+std::string print_operands(const operand_list& operands)
+{
+    std::stringstream ss;
+    for (const auto& op : operands)
+    {
+        ss << print_range(op->operand_range) << " ";
+        if (auto mach = op->access_mach())
+        {
+            if (auto expr = mach->access_expr())
+                ss << "expr " << print_expr(expr->expression);
+            else if (auto addr = mach->access_address())
+                ss << "addr " << (int)addr->state << " " << print_expr(addr->displacement) << " "
+                   << print_expr(addr->first_par) << " " << print_expr(addr->second_par);
+        }
+        else
+            ss << "other " << (int)op->type;
+        ss << "\n";
+    }
+    return ss.str();
+}
+
+std::string print_remarks(const remark_list& remarks)
+{
+    std::string result;
+    for (const auto& r : remarks)
+        result.append(print_range(r)).append("\n");
+    return result;
+}
+
+auto parse_mach(analyzer& a, const std::string& field, const range& r)
+{
+    return a.parser().parse_operand_field(&a.context(),
+        field,
+        true,
+        range_provider(r, adjusting_state::NONE),
+        std::make_pair(processing_format(processing_kind::ORDINARY, processing_form::MACH), op_code()));
+}
+
+void compare_operand_field(const std::string& field)
+{
+    range r(position(0, 4), position(0, 4 + field.size()));
+    analyzer a(" LR 1,1");
+
+    a.parser().set_simple_operand_parsing(false);
+    auto [antlr_op, antlr_rem] = parse_mach(a, field, r);
+    a.parser().set_simple_operand_parsing(true);
+    auto [simple_op, simple_rem] = parse_mach(a, field, r);
+
+    EXPECT_EQ(print_operands(simple_op.value), print_operands(antlr_op.value)) << field;
+    EXPECT_EQ(simple_op.field_range, antlr_op.field_range) << field;
+    EXPECT_EQ(print_remarks(simple_rem.value), print_remarks(antlr_rem.value)) << field;
+    EXPECT_EQ(simple_rem.field_range, antlr_rem.field_range) << field;
+}
+
+struct analysis_result
+{
+    std::vector<std::string> diags;
+    std::vector<token_info> tokens;
+    std::vector<std::string> symbols;
+};
+
+analysis_result analyze(const std::string& input, bool simple_operands)
+{
+    analyzer a(input);
+    a.parser().set_simple_operand_parsing(simple_operands);
+    a.analyze();
+    a.collect_diags();
+
+    analysis_result result;
+    for (const auto& d : a.diags())
+        result.diags.push_back(d.code + " " + print_range(d.diag_range) + " " + d.message);
+    result.tokens = a.lsp_processor().semantic_tokens();
+    for (const auto& [name, symbol] : a.context().ord_ctx.get_all_symbols())
+        result.symbols.push_back(*name + "=" + print_value(symbol.value()));
+    std::sort(result.symbols.begin(), result.symbols.end());
+    return result;
+}
+
+void compare_analysis(const std::string& input)
+{
+    auto antlr = analyze(input, false);
+    auto simple = analyze(input, true);
+
+    EXPECT_EQ(simple.diags, antlr.diags);
+    EXPECT_EQ(simple.tokens, antlr.tokens);
+    EXPECT_EQ(simple.symbols, antlr.symbols);
+}
+
+std::string get_content(const std::string& file_name)
+{
+    std::ifstream ifs(file_name);
+    EXPECT_TRUE(ifs.good()) << "Could not open file '" << file_name
+                            << "'. Tests must be started from the bin/ folder.\n";
+    return std::string((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+}
+
+} // namespace
+
+TEST(simple_operand_parser, recognized_fields)
+{
+    context::id_storage ids;
+    range_provider provider;
+
+    for (std::string field : { " R1,FIELD",
+             " R2,0(R3)",
+             " R2,4(,R13)",
+             " R2,4(R4,)",
+             " R2,LEN(R4,R13)",
+             " 1,2",
+             " *+8",
+             " R1,FIELD+4-2   REMARK",
+             " R1,A_B@$#1" })
+        EXPECT_TRUE(parse_simple_operand_field(field, position(0, 3), true, true, ids, provider)) << field;
+}
+
+TEST(simple_operand_parser, fallback_fields)
+{
+    context::id_storage ids;
+    range_provider provider;
+
+    for (std::string field : { " &VAR,1",
+             " R1,=F'1'",
+             " R1,L'FIELD",
+             " R1,X'10'",
+             " R1,A",
+             " R1,A*2",
+             " R1,(A)",
+             " R1,-A",
+             " R1,,A",
+             " R1,A.B",
+             " R1,1A",
+             " R1,1234567890",
+             " R1,AB ",
+             "R1,A",
+             " R1,(R2)",
+             " R1,0(R2)X",
+             " R1,\xC1" })
+        EXPECT_FALSE(parse_simple_operand_field(field, position(0, 3), true, true, ids, provider)) << field;
+
+    // the field reaches the continuation column
+    EXPECT_FALSE(parse_simple_operand_field(" R1,FIELD", position(0, 65), true, true, ids, provider));
+    EXPECT_TRUE(parse_simple_operand_field("R1,FIELD", position(0, 65), false, false, ids, provider));
+}
+
+TEST(simple_operand_parser, same_operands_as_parser)
+{
+    for (std::string field : { "R1,FIELD",
+             "R2,0(R3)",
+             "R2,4(,R13)",
+             "R2,4(R4,)",
+             "R2,LEN(R4,R13)",
+             "1,2",
+             "*+8",
+             "R1,FIELD+4-2   REMARK",
+             "R1,FIELD+4-2,AB,CD,1(2,3) REMARK, WITH COMMA",
+             "AA+BB-CC+12(R1,R2)" })
+        compare_operand_field(field);
+}
+
+TEST(simple_operand_parser, same_analysis_as_parser)
+{
+    compare_analysis(R"(
+TEST     CSECT
+         USING *,R12
+R1       EQU   1
+R2       EQU   2
+R12      EQU   12
+         L     R1,FIELD               LOAD
+         LA    R2,FIELD+4(R1)
+         LA    R2,FIELD+4(R1,)
+         LA    R2,FIELD+4(,R1)
+         LA    R2,FIELD-TEST(R1,R12)
+         LR    R1,R2,R2
+         ST    R1,UNDEF
+         LR    R1
+         B     *+4
+FIELD    DS    F
+LEN      EQU   *-TEST
+)");
+}
+
+TEST(simple_operand_parser, same_analysis_on_library_inputs)
+{
+    for (std::string name : { "simple",
+             "operand",
+             "continuation",
+             "model_statement",
+             "comment",
+             "macro_model",
+             "long_macro",
+             "process",
+             "cont_no_op",
+             "cont_empty_op",
+             "op_alt_format_allowed",
+             "op_alt_format_not_allowed" })
+    {
+        SCOPED_TRACE(name);
+        compare_analysis(get_content("test/library/input/" + name + ".in"));
+    }
+}
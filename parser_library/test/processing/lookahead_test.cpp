@@ -477,6 +477,15 @@ X EQU 1,2,C'X'
         R"( 
  MAC 
 &AFTER_MAC SETB 1
+)";
+
+    std::string LIB4 =
+        R"(&A SETA L'X
+&B SETA L'Y
+ LR 1,1
+X DS CL2
+ LR 1,1
+Y DS CL3
 )";
 
     virtual parse_result parse_library(
@@ -489,6 +498,8 @@ X EQU 1,2,C'X'
             content = &LIB2;
         else if (library == "LIB3")
             content = &LIB3;
+        else if (library == "LIB4")
+            content = &LIB4;
         else
             return false;
 
@@ -587,6 +598,32 @@ X EQU 1,2
     EXPECT_EQ(a.diags().size(), (size_t)0);
 }
 
+TEST(attribute_lookahead, lookup_continues_in_copy)
+{
+    look_parse_lib_prov mock;
+    analyzer a(" COPY LIB4", "", mock);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("A"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<A_t>()
+                  ->get_value(),
+        2);
+    EXPECT_EQ(a.context()
+                  .get_var_sym(a.context().ids().add("B"))
+                  ->access_set_symbol_base()
+                  ->access_set_symbol<A_t>()
+                  ->get_value(),
+        3);
+
+    // the second lookahead starts after X, where the first one stopped
+    EXPECT_EQ(a.get_metrics().lookahead_statements, (size_t)5);
+
+    EXPECT_EQ(a.diags().size(), (size_t)0);
+}
+
 TEST(attribute_lookahead, lookup_from_macro)
 {
     std::string input(
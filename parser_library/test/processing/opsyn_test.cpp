@@ -261,6 +261,46 @@ X OPSYN LR
     ASSERT_EQ(a.diags().size(), (size_t)1);
 }
 
+TEST(OPSYN, redefinition_in_macro_loop)
+{
+    std::string input(R"(
+ MACRO
+ INC1
+ GBLA &V
+&V SETA &V+1
+ MEND
+
+ MACRO
+ INC10
+ GBLA &V
+&V SETA &V+10
+ MEND
+
+ MACRO
+ LOOP
+ LCLA &I
+.L AIF (&I GE 4).E
+&I SETA &I+1
+ INC
+ AIF (&I NE 2).L
+INC OPSYN INC10
+ AGO .L
+.E MEND
+
+ GBLA &V
+INC OPSYN INC1
+ LOOP
+)");
+    analyzer a(input);
+    a.analyze();
+    a.collect_diags();
+    ASSERT_EQ(a.diags().size(), (size_t)0);
+
+    auto v = a.context().get_var_sym(a.context().ids().add("V"));
+    ASSERT_TRUE(v);
+    EXPECT_EQ(v->access_set_symbol_base()->access_set_symbol<context::A_t>()->get_value(), 22);
+}
+
 class opsyn_parse_lib_prov : public parse_lib_provider
 {
     std::unique_ptr<analyzer> a;
@@ -29,7 +29,7 @@ TEST(input_source, utf8conv)
 
     hlasm_plugin::parser_library::lexing::input_source input1(u8);
 
-    EXPECT_EQ(u8, input1.getText({ (ssize_t)0, (ssize_t)0 }));
+    EXPECT_EQ(u8, input1.getText({ (ssize_t)0, (ssize_t)3 }));
 
     u8.insert(u8.end(), (unsigned char)0xEA);
     u8.insert(u8.end(), (unsigned char)0x84);
@@ -37,20 +37,76 @@ TEST(input_source, utf8conv)
 
     hlasm_plugin::parser_library::lexing::input_source input2(u8);
 
-    EXPECT_EQ(u8, input2.getText({ (ssize_t)0, (ssize_t)1 }));
+    EXPECT_EQ(u8, input2.getText({ (ssize_t)0, (ssize_t)6 }));
 
     u8.insert(u8.end(), (unsigned char)0xC5);
     u8.insert(u8.end(), (unsigned char)0x80);
 
     hlasm_plugin::parser_library::lexing::input_source input3(u8);
 
-    EXPECT_EQ(u8, input3.getText({ (ssize_t)0, (ssize_t)2 }));
+    EXPECT_EQ(u8, input3.getText({ (ssize_t)0, (ssize_t)8 }));
 
     u8.insert(u8.end(), (unsigned char)0x41);
 
     hlasm_plugin::parser_library::lexing::input_source input4(u8);
 
-    EXPECT_EQ(u8, input4.getText({ (ssize_t)0, (ssize_t)3 }));
+    EXPECT_EQ(u8, input4.getText({ (ssize_t)0, (ssize_t)9 }));
+}
+
+TEST(input_source, utf8_characters)
+{
+    // U+10000, U+A123, U+0140, A
+    std::string u8 = "\xf0\x90\x80\x80\xEA\x84\xA3\xC5\x80\x41";
+
+    hlasm_plugin::parser_library::lexing::input_source input(u8);
+
+    EXPECT_EQ(input.LA(1), (size_t)0x10000);
+    EXPECT_EQ(input.LA(2), (size_t)0xA123);
+    EXPECT_EQ(input.LA(4), (size_t)'A');
+    EXPECT_EQ(input.LA(5), antlr4::CharStream::EOF);
+
+    input.consume();
+    EXPECT_EQ(input.index(), (size_t)4);
+    EXPECT_EQ(input.LA(1), (size_t)0xA123);
+    EXPECT_EQ(input.LA(-1), (size_t)0x10000);
+    EXPECT_EQ(input.char_count(0, 9), (size_t)4);
+
+    input.rewind_input(8);
+    EXPECT_EQ(input.index(), (size_t)7);
+    EXPECT_EQ(input.LA(1), (size_t)0x140);
+}
+
+TEST(input_source, non_owning)
+{
+    std::string text = "A\xC5\x80";
+
+    hlasm_plugin::parser_library::lexing::input_source input(
+        text, hlasm_plugin::parser_library::lexing::input_source::non_owning);
+
+    EXPECT_EQ(input.text().data(), text.data());
+
+    // the text is copied before it is modified
+    input.append("B");
+    EXPECT_NE(input.text().data(), text.data());
+    EXPECT_EQ(input.text(), "A\xC5\x80"
+                            "B");
+    EXPECT_EQ(text, "A\xC5\x80");
+}
+
+TEST(input_source, utf16_column)
+{
+    // A, U+10000, U+0140, B
+    std::string u8 = "A\xf0\x90\x80\x80\xC5\x80"
+                     "B";
+
+    hlasm_plugin::parser_library::lexing::input_source input(u8);
+
+    EXPECT_EQ(input.utf16_column({ 0, 0 }, 1), (size_t)1);
+    EXPECT_EQ(input.utf16_column({ 0, 0 }, 5), (size_t)3);
+    EXPECT_EQ(input.utf16_column({ 0, 0 }, 7), (size_t)4);
+    EXPECT_EQ(input.utf16_column({ 5, 10 }, 8), (size_t)12);
+    EXPECT_EQ(input.utf16_column({ 5, 10 }, 100), (size_t)12);
+    EXPECT_EQ(input.utf16_column({ 5, 10 }, 5), (size_t)10);
 }
 
 TEST(ebcdic_encoding, unicode)
@@ -159,4 +215,15 @@ TEST(replace_non_utf8_chars, middle_char)
     EXPECT_EQ(res[begin.size() + 2], '\xBD');
     EXPECT_EQ(res.substr(0, begin.size()), begin);
     EXPECT_EQ(res.substr(begin.size() + 3), end);
-}
\ No newline at end of file
+}
+
+TEST(replace_non_utf8_chars, long_text)
+{
+    // invalid characters after and inside of blocks of ascii characters
+    std::string ascii = "this is some long ascii string";
+    std::string u8 = ascii + "\xC5\x80" + ascii + '\x80' + ascii + "\xEA\x84";
+
+    std::string res = file_impl::replace_non_utf8_chars(u8);
+
+    EXPECT_EQ(res, ascii + "\xC5\x80" + ascii + "\xEF\xBF\xBD" + ascii + "\xEF\xBF\xBD\xEF\xBF\xBD");
+}
@@ -12,6 +12,8 @@
  *   Broadcom, Inc. - initial API and implementation
  */
 
+#include <filesystem>
+
 #include "gtest/gtest.h"
 
 #include "workspaces/file_manager_impl.h"
@@ -76,3 +78,67 @@ TEST(extension_handling_test, extension_removal)
     library_local lib4(file_mngr, "lib2", std::make_shared<const extension_regex_map>(map2));
     EXPECT_EQ(lib4.find_file("MAC"), nullptr);
 }
+
+class file_manager_refresh_mock : public file_manager_impl
+{
+public:
+    virtual std::unordered_map<std::string, std::string> list_directory_files(const std::string&) override
+    {
+        ++listed;
+        if (mac_exists)
+            return { { "Mac.hlasm", lib_path + "Mac.hlasm" } };
+        return {};
+    }
+
+    virtual bool file_exists(const std::string&) override { return mac_exists; }
+
+    bool mac_exists = true;
+    size_t listed = 0;
+};
+
+TEST(extension_handling_test, refresh_normalized_paths)
+{
+    file_manager_refresh_mock file_mngr;
+    extension_regex_map map { { ".hlasm", wildcard2regex("*.hlasm") } };
+    library_local lib(file_mngr, lib_path, std::make_shared<const extension_regex_map>(map));
+    EXPECT_NE(lib.find_file("MAC"), nullptr);
+    EXPECT_EQ(file_mngr.listed, (size_t)1);
+
+    // the member is removed even though the path is not in its normal form
+    file_mngr.mac_exists = false;
+    const std::filesystem::path denormalized = std::filesystem::path("other") / ".." / "lib" / "." / "Mac.hlasm";
+    EXPECT_TRUE(lib.refresh(denormalized.string()));
+    EXPECT_EQ(lib.find_file("MAC"), nullptr);
+    EXPECT_EQ(file_mngr.listed, (size_t)1);
+
+    // files of other directories are ignored
+    file_mngr.mac_exists = true;
+    EXPECT_FALSE(lib.refresh((std::filesystem::path("lib2") / "Mac.hlasm").string()));
+    EXPECT_EQ(lib.find_file("MAC"), nullptr);
+
+    // the library directory itself, with a trailing separator
+    EXPECT_TRUE(lib.refresh(lib_path));
+    EXPECT_NE(lib.find_file("MAC"), nullptr);
+    EXPECT_EQ(file_mngr.listed, (size_t)2);
+
+    // a directory above the library
+    file_mngr.mac_exists = false;
+    const auto parent = std::filesystem::absolute(lib_path).parent_path().parent_path();
+    library_local abs_lib(
+        file_mngr, std::filesystem::absolute(lib_path).string(), std::make_shared<const extension_regex_map>(map));
+    EXPECT_EQ(abs_lib.find_file("MAC"), nullptr);
+    file_mngr.mac_exists = true;
+    EXPECT_TRUE(abs_lib.refresh(parent.string()));
+    EXPECT_NE(abs_lib.find_file("MAC"), nullptr);
+}
+
+TEST(extension_handling_test, has_file)
+{
+    file_manager_refresh_mock file_mngr;
+    extension_regex_map map { { ".hlasm", wildcard2regex("*.hlasm") } };
+    library_local lib(file_mngr, lib_path, std::make_shared<const extension_regex_map>(map));
+
+    EXPECT_TRUE(lib.has_file(lib_path + "Mac.hlasm"));
+    EXPECT_FALSE(lib.has_file(lib_path + "Other.hlasm"));
+    EXPECT_FALSE(lib.has_file(lib_path2 + "Mac.hlasm"));
+}
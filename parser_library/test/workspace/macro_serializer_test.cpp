@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 Broadcom.
+ * The term "Broadcom" refers to Broadcom Inc. and/or its subsidiaries.
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Contributors:
+ *   Broadcom, Inc. - initial API and implementation
+ */
+
+#include "gtest/gtest.h"
+
+#include "../common_testing.h"
+#include "workspaces/macro_serializer.h"
+
+// tests of the binary form of macro definitions
+
+namespace {
+
+// parses the library macro MAC, or takes its definition from the binary form when it is provided
+class serializer_mock : public parse_lib_provider
+{
+    std::string content_;
+
+public:
+    explicit serializer_mock(std::string content)
+        : content_(std::move(content))
+    {}
+
+    virtual parse_result parse_library(const std::string&, context::hlasm_context& hlasm_ctx, const library_data data)
+    {
+        if (stored)
+        {
+            auto result = deserialize_macro(*stored, hlasm_ctx.ids());
+            if (!result)
+                return false;
+            hlasm_ctx.add_macro(result->macro);
+            return true;
+        }
+        a = std::make_unique<analyzer>(content_, "MAC", hlasm_ctx, *this, data);
+        a->analyze();
+        a->collect_diags();
+        return true;
+    }
+    virtual bool has_library(const std::string&, context::hlasm_context&) const { return true; }
+
+    std::unique_ptr<analyzer> a;
+    std::optional<std::string> stored;
+};
+
+const std::string macro_content = R"(   MACRO
+&L     MAC   &P,&K=(A,B),&E=
+       GBLA  &X
+       GBLC  &Y
+       AIF   ('&P' EQ 'SKIP').END
+&X     SETA  &X+1
+.END   ANOP
+&Y     SETC  '&K(2)&E'
+&L     DS    F
+&L.A   DS    F
+       MEND
+)";
+
+const std::string opencode = R"(
+ GBLA &X
+ GBLC &Y
+LBL MAC 1
+ MAC SKIP,E=C
+)";
+
+std::string serialize_library_macro(analyzer& a)
+{
+    auto macro = a.context().macros().at(a.context().ids().add("MAC"));
+    auto data = serialize_macro(*macro, {});
+    EXPECT_TRUE(data);
+    return data.value_or("");
+}
+
+void check_results(analyzer& a)
+{
+    EXPECT_EQ(dynamic_cast<diagnosable*>(&a)->diags().size(), (size_t)0);
+
+    auto X = a.context().globals().find(a.context().ids().add("X"));
+    ASSERT_NE(X, a.context().globals().end());
+    EXPECT_EQ(X->second->access_set_symbol<A_t>()->get_value(), 1);
+
+    auto Y = a.context().globals().find(a.context().ids().add("Y"));
+    ASSERT_NE(Y, a.context().globals().end());
+    EXPECT_EQ(Y->second->access_set_symbol<C_t>()->get_value(), "BC");
+
+    EXPECT_TRUE(a.context().ord_ctx.get_symbol(a.context().ids().add("LBL")));
+    EXPECT_TRUE(a.context().ord_ctx.get_symbol(a.context().ids().add("LBLA")));
+}
+
+} // namespace
+
+TEST(macro_serializer, round_trip)
+{
+    serializer_mock m(macro_content);
+    analyzer a(opencode, "", m);
+    a.analyze();
+    a.collect_diags();
+    check_results(a);
+
+    auto data = serialize_library_macro(a);
+
+    // the definition recreated in another identifier storage has the same binary form
+    context::id_storage ids;
+    auto result = deserialize_macro(data, ids);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result->macro->id, "MAC");
+    EXPECT_EQ(result->macro->cached_definition.size(),
+        a.context().macros().at(a.context().ids().add("MAC"))->cached_definition.size());
+    EXPECT_EQ(serialize_macro(*result->macro, {}), data);
+}
+
+TEST(macro_serializer, stored_definition_is_used)
+{
+    std::string data;
+    {
+        serializer_mock m(macro_content);
+        analyzer a(opencode, "", m);
+        a.analyze();
+        data = serialize_library_macro(a);
+    }
+
+    // the library is not parsed, the macro is created from the binary form
+    serializer_mock m("");
+    m.stored = data;
+    analyzer a(opencode, "", m);
+    a.analyze();
+    a.collect_diags();
+
+    EXPECT_FALSE(m.a);
+    check_results(a);
+}
+
+TEST(macro_serializer, unsupported_statements)
+{
+    // the label contains a subscript, that is a conditional assembly expression
+    serializer_mock m(R"(   MACRO
+       MAC
+       LCLA  &A(2)
+&A(1)  SETA  1
+       MEND
+)");
+    analyzer a(" MAC", "", m);
+    a.analyze();
+
+    auto macro = a.context().macros().at(a.context().ids().add("MAC"));
+    EXPECT_FALSE(serialize_macro(*macro, {}));
+}
+
+TEST(macro_serializer, damaged_data)
+{
+    serializer_mock m(macro_content);
+    analyzer a(opencode, "", m);
+    a.analyze();
+    auto data = serialize_library_macro(a);
+
+    context::id_storage ids;
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_FALSE(deserialize_macro(std::string_view(data).substr(0, i), ids)) << i;
+
+    // data of another version of the format
+    auto other_version = data;
+    other_version[8] = (char)(macro_format_version + 1);
+    EXPECT_FALSE(deserialize_macro(other_version, ids));
+
+    EXPECT_FALSE(deserialize_macro(data + "X", ids));
+}
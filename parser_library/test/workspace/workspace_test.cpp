@@ -16,6 +16,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <set>
 
 #include "gtest/gtest.h"
 
@@ -194,6 +195,11 @@ public:
         return { { "ERROR", "ERROR" } };
     }
 
+    virtual bool file_exists(const std::string& file_name) override
+    {
+        return file_name != correct_macro_path || insert_correct_macro;
+    }
+
     bool insert_correct_macro = true;
 };
 
@@ -253,16 +259,410 @@ TEST_F(workspace_test, did_change_watched_files)
 
     // remove the macro, there should still be 1 diagnostic E049 that the ERROR was not found
     file_manager.insert_correct_macro = false;
-    ws.did_change_watched_files(correct_macro_path);
+    ws.did_change_watched_files({ correct_macro_path });
     ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)1);
     EXPECT_STREQ(diags()[0].code.c_str(), "E049");
 
     // put it back and make some change in the source file, the diagnostic will disappear
     file_manager.insert_correct_macro = true;
-    ws.did_change_watched_files(correct_macro_path);
+    ws.did_change_watched_files({ correct_macro_path });
     std::vector<document_change> changes;
     std::string new_text = "";
     changes.push_back(document_change({ { 0, 0 }, { 0, 0 } }, new_text.c_str(), new_text.size()));
     ws.did_change_file("source3", changes.data(), changes.size());
     ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)0);
 }
+
+TEST_F(workspace_test, macro_cache)
+{
+    file_manager_extended file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    EXPECT_GT(file_manager.find_processor_file("source1")->get_metrics().macro_def_statements, (size_t)0);
+
+    // the second program uses the same macro, its definition is taken from the cache
+    ws.did_open_file("source2");
+    EXPECT_EQ(file_manager.find_processor_file("source2")->get_metrics().macro_def_statements, (size_t)0);
+    ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)3);
+    EXPECT_TRUE(match_strings({ faulty_macro_path, "source2", "source1" }));
+
+    // the change of the macro invalidates the cached definition
+    std::vector<document_change> changes;
+    std::string new_text = "";
+    changes.push_back(document_change({ { 0, 0 }, { 0, 0 } }, new_text.c_str(), new_text.size()));
+    file_manager.did_change_file(faulty_macro_path, 1, changes.data(), changes.size());
+    ws.did_change_file(faulty_macro_path, changes.data(), changes.size());
+    EXPECT_GT(file_manager.find_processor_file("source1")->get_metrics().macro_def_statements, (size_t)0);
+    EXPECT_EQ(file_manager.find_processor_file("source2")->get_metrics().macro_def_statements, (size_t)0);
+}
+
+TEST_F(workspace_test, macro_cache_lsp)
+{
+    file_manager_extended file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source2");
+    ASSERT_EQ(file_manager.find_processor_file("source2")->get_metrics().macro_def_statements, (size_t)0);
+
+    // the program using the cached macro gets the same language information as the one that parsed it
+    const auto& parsed = file_manager.find_processor_file("source1")->get_lsp_info();
+    const auto& cached = file_manager.find_processor_file("source2")->get_lsp_info();
+
+    const position macro_call(0, 2);
+    EXPECT_EQ(cached.go_to_definition(macro_call), parsed.go_to_definition(macro_call));
+    EXPECT_EQ(cached.go_to_definition(macro_call).uri, faulty_macro_path);
+
+    auto parsed_references = parsed.references(macro_call);
+    auto cached_references = cached.references(macro_call);
+    ASSERT_EQ(cached_references.size(), parsed_references.size());
+    EXPECT_TRUE(std::any_of(cached_references.begin(), cached_references.end(), [](const auto& ref) {
+        return ref.uri == faulty_macro_path;
+    }));
+}
+
+std::string copy_member_file = R"( AAA 1,1)";
+
+std::string source_using_copy = R"( COPY COPYM)";
+
+std::string source_using_copy_opsyn = R"(AAA OPSYN LR
+ COPY COPYM)";
+
+#ifdef _WIN32
+constexpr const char* copy_member_path = "lib\\COPYM";
+#else
+constexpr const char* copy_member_path = "lib/COPYM";
+#endif // _WIN32
+
+class file_manager_opsyn : public file_manager_extended
+{
+public:
+    file_manager_opsyn()
+    {
+        files_["source1"] = std::make_shared<file_with_text>("source1", source_using_copy);
+        files_["source2"] = std::make_shared<file_with_text>("source2", source_using_copy_opsyn);
+        files_["source3"] = std::make_shared<file_with_text>("source3", source_using_copy_opsyn);
+        files_[copy_member_path] = std::make_shared<file_with_text>(copy_member_path, copy_member_file);
+    }
+
+    virtual std::unordered_map<std::string, std::string> list_directory_files(const std::string&) override
+    {
+        return { { "COPYM", "COPYM" } };
+    }
+};
+
+TEST_F(workspace_test, macro_cache_opsyn)
+{
+    file_manager_opsyn file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    EXPECT_GT(file_manager.find_processor_file("source1")->get_metrics().copy_def_statements, (size_t)0);
+
+    // the member is processed differently with OPSYN, so it is not taken from the cache
+    ws.did_open_file("source2");
+    EXPECT_GT(file_manager.find_processor_file("source2")->get_metrics().copy_def_statements, (size_t)0);
+
+    // the same mnemonics share the cached member
+    ws.did_open_file("source3");
+    EXPECT_EQ(file_manager.find_processor_file("source3")->get_metrics().copy_def_statements, (size_t)0);
+}
+
+std::string macro_with_bad_operands = R"( MACRO
+ BADOP
+ LR 1,(
+ MEND
+)";
+
+std::string source_using_bad_operands = R"( BADOP)";
+
+#ifdef _WIN32
+constexpr const char* bad_operands_macro_path = "lib\\BADOP";
+#else
+constexpr const char* bad_operands_macro_path = "lib/BADOP";
+#endif // _WIN32
+
+class file_manager_bad_operands : public file_manager_extended
+{
+public:
+    file_manager_bad_operands()
+    {
+        files_["source1"] = std::make_shared<file_with_text>("source1", source_using_bad_operands);
+        files_["source2"] = std::make_shared<file_with_text>("source2", source_using_bad_operands);
+        files_[bad_operands_macro_path] =
+            std::make_shared<file_with_text>(bad_operands_macro_path, macro_with_bad_operands);
+    }
+
+    virtual std::unordered_map<std::string, std::string> list_directory_files(const std::string&) override
+    {
+        return { { "BADOP", "BADOP" } };
+    }
+};
+
+TEST_F(workspace_test, macro_cache_operand_diagnostics)
+{
+    file_manager_bad_operands file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    auto first_size = collect_and_get_diags_size(ws, file_manager);
+    ASSERT_GT(first_size, (size_t)0);
+    std::vector<std::string> first_codes;
+    for (const auto& diag : diags())
+        first_codes.push_back(diag.code);
+
+    // the operands of the macro statement were parsed by the previous analysis,
+    // the analysis after an edit still reports their diagnostics
+    ws.did_change_file("source1", nullptr, 0);
+    ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), first_size);
+    for (size_t i = 0; i < first_size; ++i)
+        EXPECT_EQ(diags()[i].code, first_codes[i]);
+
+    // so does another program using the cached macro
+    ws.did_open_file("source2");
+    EXPECT_EQ(collect_and_get_diags_size(ws, file_manager), 2 * first_size);
+}
+
+TEST_F(workspace_test, persistent_macro_cache)
+{
+    auto storage = std::filesystem::path(".hlasmplugin") / "macro_cache";
+    std::filesystem::remove_all(storage);
+
+    lib_config config;
+    config.persistent_macro_cache = true;
+    {
+        file_manager_extended file_manager;
+        workspace ws("", "workspace_name", file_manager, config);
+        ws.open();
+        ws.did_open_file("source1");
+        ws.did_open_file("source3");
+        EXPECT_GT(file_manager.find_processor_file("source3")->get_metrics().macro_def_statements, (size_t)0);
+    }
+
+    // only the macro without errors is stored
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(storage), std::filesystem::directory_iterator()), 1);
+
+    // after a restart, the unchanged macro is not parsed again
+    {
+        file_manager_extended file_manager;
+        workspace ws("", "workspace_name", file_manager, config);
+        ws.open();
+        ws.did_open_file("source1");
+        ws.did_open_file("source3");
+        EXPECT_GT(file_manager.find_processor_file("source1")->get_metrics().macro_def_statements, (size_t)0);
+        EXPECT_EQ(file_manager.find_processor_file("source3")->get_metrics().macro_def_statements, (size_t)0);
+        ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)2);
+        EXPECT_TRUE(match_strings({ faulty_macro_path, "source1" }));
+    }
+
+    std::filesystem::remove_all(storage);
+    // the folder is removed only when the test created it
+    std::error_code ec;
+    std::filesystem::remove(storage.parent_path(), ec);
+}
+
+TEST_F(workspace_test, persistent_macro_cache_configuration_changed)
+{
+    auto storage = std::filesystem::path(".hlasmplugin") / "macro_cache";
+    std::filesystem::remove_all(storage);
+
+    lib_config config;
+    config.persistent_macro_cache = false;
+    file_manager_extended file_manager;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source3");
+    EXPECT_FALSE(std::filesystem::exists(storage));
+
+    // the setting is applied when the configuration changes, not by the library lookups
+    config.persistent_macro_cache = true;
+    ws.configuration_changed();
+    file_manager.did_change_file(correct_macro_path, 1, nullptr, 0);
+    ws.did_change_file(correct_macro_path, nullptr, 0);
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(storage), std::filesystem::directory_iterator()), 1);
+
+    std::filesystem::remove_all(storage);
+    std::error_code ec;
+    std::filesystem::remove(storage.parent_path(), ec);
+}
+
+TEST_F(workspace_test, parallel_reparse_after_config_change)
+{
+    file_manager_extended file_manager;
+    lib_config config;
+    config.parallel_analysis_workers = 4;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source2");
+    ws.did_open_file("source3");
+    ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)3);
+
+    // all the programs are analyzed again, the diagnostics stay the same
+    ws.did_change_file(hlasmplugin_folder + "proc_grps.json", nullptr, 0);
+    ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)3);
+    EXPECT_TRUE(match_strings({ faulty_macro_path, "source2", "source1" }));
+
+    // the macros are still resolved from the library
+    for (const auto& diag : diags())
+        EXPECT_NE(diag.code, "E049");
+
+    const std::set<std::string> faulty_deps { faulty_macro_path };
+    const std::set<std::string> correct_deps { correct_macro_path };
+    EXPECT_EQ(file_manager.find_processor_file("source1")->dependencies(), faulty_deps);
+    EXPECT_EQ(file_manager.find_processor_file("source2")->dependencies(), faulty_deps);
+    EXPECT_EQ(file_manager.find_processor_file("source3")->dependencies(), correct_deps);
+}
+
+TEST_F(workspace_test, proc_grp_cache)
+{
+    file_manager_extended file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    EXPECT_GT(file_manager.find_processor_file("source1")->get_metrics().proc_grp_cache_hits, (size_t)0);
+    EXPECT_EQ(&ws.get_proc_grp_by_program("source1"), &ws.get_proc_grp("P1"));
+
+    // reloading the configuration clears the cache
+    ws.did_change_file(hlasmplugin_folder + "pgm_conf.json", nullptr, 0);
+    EXPECT_EQ(&ws.get_proc_grp_by_program("source1"), &ws.get_proc_grp("P1"));
+}
+
+TEST_F(workspace_test, did_change_watched_files_burst)
+{
+    file_manager_extended file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source3");
+    EXPECT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)2);
+
+    // both macros change at once, each program is parsed only once
+    file_manager.insert_correct_macro = false;
+    ws.did_change_watched_files({ correct_macro_path, faulty_macro_path });
+    ASSERT_EQ(collect_and_get_diags_size(ws, file_manager), (size_t)3);
+    EXPECT_TRUE(match_strings({ faulty_macro_path, "source1", "source3" }));
+}
+
+class file_with_parse_count : public file_with_text
+{
+public:
+    file_with_parse_count(const std::string& name, const std::string& text)
+        : file_impl(name)
+        , file_with_text(name, text)
+    {}
+
+    virtual parse_result parse(parse_lib_provider& lib_provider) override
+    {
+        ++parse_count;
+        return file_with_text::parse(lib_provider);
+    }
+
+    size_t parse_count = 0;
+};
+
+class file_manager_parse_count : public file_manager_extended
+{
+public:
+    file_manager_parse_count()
+    {
+        files_["source1"] = std::make_shared<file_with_parse_count>("source1", source_using_macro_file);
+        files_["source2"] = std::make_shared<file_with_parse_count>("source2", source_using_macro_file);
+        files_["source3"] = std::make_shared<file_with_parse_count>("source3", source_using_macro_file_no_error);
+    }
+
+    size_t parse_count(const std::string& name)
+    {
+        return dynamic_cast<file_with_parse_count&>(*find_processor_file(name)).parse_count;
+    }
+
+    // closed files are not counted anymore
+    void reset_parse_counts()
+    {
+        for (const char* name : { "source1", "source2", "source3" })
+            if (auto file = find_processor_file(name))
+                dynamic_cast<file_with_parse_count&>(*file).parse_count = 0;
+    }
+};
+
+TEST_F(workspace_test, dependants_reparsed_after_macro_change)
+{
+    file_manager_parse_count file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source2");
+    ws.did_open_file("source3");
+    file_manager.reset_parse_counts();
+
+    // only the programs using the macro are parsed again
+    ws.did_change_file(faulty_macro_path, nullptr, 0);
+    EXPECT_EQ(file_manager.parse_count("source1"), (size_t)1);
+    EXPECT_EQ(file_manager.parse_count("source2"), (size_t)1);
+    EXPECT_EQ(file_manager.parse_count("source3"), (size_t)0);
+}
+
+TEST_F(workspace_test, dependants_index_dropped_dependency)
+{
+    file_manager_parse_count file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source2");
+
+    // source2 does not use the macro anymore
+    std::vector<document_change> changes;
+    std::string new_text = "";
+    changes.push_back(document_change({ { 0, 0 }, { 0, 6 } }, new_text.c_str(), new_text.size()));
+    file_manager.did_change_file("source2", 1, changes.data(), changes.size());
+    ws.did_change_file("source2", changes.data(), changes.size());
+    EXPECT_TRUE(file_manager.find_processor_file("source2")->dependencies().empty());
+    file_manager.reset_parse_counts();
+
+    ws.did_change_file(faulty_macro_path, nullptr, 0);
+    EXPECT_EQ(file_manager.parse_count("source1"), (size_t)1);
+    EXPECT_EQ(file_manager.parse_count("source2"), (size_t)0);
+}
+
+TEST_F(workspace_test, dependants_index_shared_dependency_close)
+{
+    file_manager_parse_count file_manager;
+    lib_config config;
+    workspace ws("", "workspace_name", file_manager, config);
+    ws.open();
+
+    ws.did_open_file("source1");
+    ws.did_open_file("source2");
+    // the macro is not open in the editor, it is kept only as a dependency
+    ws.did_close_file(faulty_macro_path);
+
+    // source2 still uses the macro, so it stays open
+    ws.did_close_file("source1");
+    ASSERT_NE(file_manager.find(faulty_macro_path), nullptr);
+    file_manager.reset_parse_counts();
+    ws.did_change_file(faulty_macro_path, nullptr, 0);
+    EXPECT_EQ(file_manager.parse_count("source2"), (size_t)1);
+
+    // the last dependant closes it
+    ws.did_close_file("source2");
+    EXPECT_EQ(file_manager.find(faulty_macro_path), nullptr);
+}